@@ -0,0 +1,69 @@
+#pragma once
+
+#include <google/protobuf/descriptor.pb.h>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace flowdriver {
+
+/**
+ * @brief On-disk cache of compiled .proto files
+ *
+ * Stores the FileDescriptorSet produced by parsing a .proto file and all of
+ * its imports, keyed by the SHA-256 of the root file's path and content.
+ * Each entry records the digest of every imported file, so editing any of
+ * them invalidates the entry. Hashing the sources is much cheaper than
+ * parsing them again.
+ */
+class DescriptorCache {
+public:
+    struct Options {
+        std::filesystem::path directory;  // Defaults to descriptors in the user's cache location
+    };
+
+    DescriptorCache();
+    explicit DescriptorCache(Options options);
+
+    DescriptorCache(const DescriptorCache&) = delete;
+    DescriptorCache& operator=(const DescriptorCache&) = delete;
+
+    /**
+     * @brief Cache shared by the whole process
+     */
+    static DescriptorCache& instance();
+
+    /**
+     * @brief Descriptors for a .proto file, if cached and none of its sources changed
+     * @param proto_file Root .proto file
+     * @param source_root Directory import paths are resolved against
+     */
+    std::optional<google::protobuf::FileDescriptorSet> load(const std::filesystem::path& proto_file,
+                                                            const std::filesystem::path& source_root) const;
+
+    /**
+     * @brief Store the descriptors compiled from a .proto file
+     * @param proto_file Root .proto file
+     * @param source_root Directory import paths are resolved against
+     * @param descriptors The root file and all its dependencies, dependencies first
+     */
+    void store(const std::filesystem::path& proto_file, const std::filesystem::path& source_root,
+               const google::protobuf::FileDescriptorSet& descriptors) const;
+
+    /**
+     * @brief Hex encoded SHA-256 digest
+     */
+    static std::string sha256(std::string_view data);
+
+private:
+    std::optional<std::string> entryKey(const std::filesystem::path& proto_file) const;
+    std::filesystem::path entryPath(const std::string& key) const;
+
+    Options m_options;
+    bool m_enabled{true};
+    mutable std::mutex m_mutex;  // Serializes writers of the same entry
+};
+
+} // namespace flowdriver
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <expected>
+#include <stdexcept>
 #include <string>
 #include <system_error>
+#include <utility>
 
 namespace flowdriver {
 
@@ -31,4 +34,28 @@ private:
     ErrorCode m_code;
 };
 
+/**
+ * @brief Value or Error, returned by paths that must not throw
+ */
+template<typename T>
+using Expected = std::expected<T, Error>;
+
+/**
+ * @brief Build the error alternative of an Expected
+ */
+inline std::unexpected<Error> makeError(ErrorCode code, const std::string& message) {
+    return std::unexpected<Error>(std::in_place, code, message);
+}
+
+/**
+ * @brief Unwrap an Expected, throwing the contained Error on failure
+ */
+template<typename T>
+T valueOrThrow(Expected<T>&& expected) {
+    if (!expected) {
+        throw std::move(expected.error());
+    }
+    return std::move(*expected);
+}
+
 } // namespace flowdriver 
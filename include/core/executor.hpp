@@ -0,0 +1,133 @@
+#pragma once
+
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace flowdriver {
+
+/**
+ * @brief Process-wide executor shared by all protocol handlers
+ *
+ * Combines a fixed work-stealing thread pool for blocking request work with
+ * a pool of io_contexts for asynchronous I/O. The task queue is bounded:
+ * submitters block once it is full, tasks submitted from a worker thread run
+ * inline instead so nested submissions cannot deadlock the pool.
+ */
+class Executor {
+public:
+    using Task = std::move_only_function<void()>;
+
+    struct Options {
+        std::size_t worker_threads{0};    // 0 selects hardware concurrency
+        std::size_t io_threads{2};
+        std::size_t queue_capacity{4096};
+    };
+
+    struct Metrics {
+        std::size_t worker_threads{0};
+        std::size_t io_threads{0};
+        std::size_t queue_depth{0};
+        std::size_t queue_capacity{0};
+        std::size_t busy_workers{0};
+        double utilisation{0.0};          // Busy workers / worker threads
+        std::uint64_t tasks_completed{0};
+        std::uint64_t tasks_stolen{0};
+        std::uint64_t tasks_rejected{0};  // tryPost calls refused because the queue was full
+        std::uint64_t submit_waits{0};    // Submissions that had to wait for queue space
+    };
+
+    Executor();
+    explicit Executor(Options options);
+    ~Executor();
+
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    /**
+     * @brief Executor shared by the whole process
+     */
+    static Executor& instance();
+
+    /**
+     * @brief Queue a task, blocking while the queue is full
+     * @param task Task to run on a worker thread
+     */
+    void post(Task task);
+
+    /**
+     * @brief Queue a task without blocking
+     * @return False if the queue is full
+     */
+    bool tryPost(Task task);
+
+    /**
+     * @brief Run a callable on the pool
+     * @return Future for the callable's result
+     */
+    template<typename F>
+    auto submit(F&& f) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+        using R = std::invoke_result_t<std::decay_t<F>>;
+        std::packaged_task<R()> task(std::forward<F>(f));
+        auto future = task.get_future();
+        post([task = std::move(task)]() mutable { task(); });
+        return future;
+    }
+
+    /**
+     * @brief Next io_context of the I/O pool (round robin)
+     */
+    boost::asio::io_context& ioContext();
+
+    Metrics metrics() const;
+
+    /**
+     * @brief True when called from one of the pool's worker threads
+     */
+    bool isWorkerThread() const;
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void workerLoop(std::size_t index);
+    bool popTask(std::size_t index, Task& task);
+    void enqueue(Task task);
+
+    Options m_options;
+    std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+    std::vector<std::thread> m_workers;
+
+    mutable std::mutex m_waitMutex;
+    std::condition_variable m_workAvailable;
+    std::condition_variable m_spaceAvailable;
+    std::size_t m_pending{0};
+    bool m_stopping{false};
+
+    std::atomic<std::size_t> m_nextQueue{0};
+    std::atomic<std::size_t> m_busy{0};
+    std::atomic<std::uint64_t> m_completed{0};
+    std::atomic<std::uint64_t> m_stolen{0};
+    std::atomic<std::uint64_t> m_rejected{0};
+    std::atomic<std::uint64_t> m_waits{0};
+
+    using WorkGuard = boost::asio::executor_work_guard<boost::asio::io_context::executor_type>;
+    std::vector<std::unique_ptr<boost::asio::io_context>> m_ioContexts;
+    std::vector<WorkGuard> m_ioGuards;
+    std::vector<std::thread> m_ioThreads;
+    std::atomic<std::size_t> m_nextIoContext{0};
+};
+
+} // namespace flowdriver
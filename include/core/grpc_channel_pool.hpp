@@ -0,0 +1,87 @@
+#pragma once
+
+#include <grpcpp/channel.h>
+#include <grpcpp/generic/generic_stub.h>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace flowdriver {
+
+/**
+ * @brief Fixed set of gRPC channels that calls are spread over
+ *
+ * A single channel multiplexes every call on one HTTP/2 connection and stalls
+ * at the server's max-concurrent-streams limit. Each pooled channel uses its
+ * own subchannel pool (GRPC_ARG_USE_LOCAL_SUBCHANNEL_POOL), so it opens its
+ * own connections instead of sharing them with identically configured
+ * channels. next() hands out the channels round robin.
+ *
+ * Address literals share one target. Host names each become a target of
+ * their own, with the channels spread over them.
+ */
+class ChannelPool {
+public:
+    enum class LoadBalancing {
+        PICK_FIRST,   // Stick to the first reachable address of a channel's target
+        ROUND_ROBIN   // Spread calls over all addresses of a channel's target
+    };
+
+    enum class Compression {
+        NONE,
+        DEFLATE,
+        GZIP
+    };
+
+    struct Options {
+        std::vector<std::string> endpoints;  // host:port, at least one
+        bool use_ssl{false};
+        std::size_t channels{1};
+        LoadBalancing load_balancing{LoadBalancing::PICK_FIRST};
+        std::chrono::milliseconds keepalive_time{0};  // 0 disables keepalive pings
+        std::chrono::milliseconds keepalive_timeout{20000};
+        bool keepalive_without_calls{false};
+        Compression compression{Compression::NONE};
+    };
+
+    explicit ChannelPool(Options options);
+
+    ChannelPool(const ChannelPool&) = delete;
+    ChannelPool& operator=(const ChannelPool&) = delete;
+
+    /**
+     * @brief Stub of the next channel (round robin)
+     */
+    grpc::GenericStub& next();
+
+    /**
+     * @brief First channel, for one-off calls such as reflection
+     */
+    std::shared_ptr<grpc::Channel> channel() const { return m_members.front().channel; }
+
+    std::size_t size() const { return m_members.size(); }
+    const Options& options() const { return m_options; }
+
+    /**
+     * @brief Split a comma separated endpoint list, ignoring blanks
+     */
+    static std::vector<std::string> splitEndpoints(std::string_view list);
+
+private:
+    struct Member {
+        std::shared_ptr<grpc::Channel> channel;
+        std::unique_ptr<grpc::GenericStub> stub;
+    };
+
+    std::vector<std::string> targets() const;
+
+    Options m_options;
+    std::vector<Member> m_members;
+    std::atomic<std::size_t> m_next{0};
+};
+
+} // namespace flowdriver
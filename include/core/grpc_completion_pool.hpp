@@ -0,0 +1,62 @@
+#pragma once
+
+#include <grpcpp/completion_queue.h>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace flowdriver {
+
+/**
+ * @brief Long-lived gRPC completion queues, each polled by a dedicated thread
+ *
+ * Asynchronous calls pass a Tag as the completion tag. When the operation
+ * finishes the polling thread invokes Tag::proceed(), so no caller thread
+ * blocks on CompletionQueue::Next().
+ */
+class CompletionQueuePool {
+public:
+    /**
+     * @brief Completion tag of an asynchronous operation
+     */
+    class Tag {
+    public:
+        virtual ~Tag() = default;
+
+        /**
+         * @brief Called on the polling thread when the operation completes
+         * @param ok Completion status reported by the queue
+         */
+        virtual void proceed(bool ok) = 0;
+    };
+
+    CompletionQueuePool();
+    explicit CompletionQueuePool(std::size_t threads);
+    ~CompletionQueuePool();
+
+    CompletionQueuePool(const CompletionQueuePool&) = delete;
+    CompletionQueuePool& operator=(const CompletionQueuePool&) = delete;
+
+    /**
+     * @brief Pool shared by the whole process
+     */
+    static CompletionQueuePool& instance();
+
+    /**
+     * @brief Next completion queue (round robin)
+     */
+    grpc::CompletionQueue* next();
+
+    std::size_t size() const { return m_queues.size(); }
+
+private:
+    void poll(grpc::CompletionQueue* queue);
+
+    std::vector<std::unique_ptr<grpc::CompletionQueue>> m_queues;
+    std::vector<std::thread> m_threads;
+    std::atomic<std::size_t> m_next{0};
+};
+
+} // namespace flowdriver
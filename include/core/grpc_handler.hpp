@@ -1,49 +1,199 @@
 #pragma once
 
+#include "core/grpc_channel_pool.hpp"
+#include "core/grpc_reflection.hpp"
 #include "core/protocol_handler.hpp"
 #include <QVariantList>
+#include <boost/asio/awaitable.hpp>
 #include <grpcpp/grpcpp.h>
 #include <grpcpp/generic/generic_stub.h>
 #include <google/protobuf/compiler/importer.h>
+#include <google/protobuf/descriptor.pb.h>
+#include <google/protobuf/descriptor_database.h>
 #include <google/protobuf/dynamic_message.h>
 #include <google/protobuf/util/json_util.h>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <unordered_map>
+#include <unordered_set>
 #include <future>
 
 namespace flowdriver {
 
+/**
+ * @brief Message received on a streaming call
+ */
+struct StreamMessage {
+    std::size_t index{0};             // Position within the stream
+    std::string body;                 // JSON, or the protobuf bytes in BINARY payload mode
+    std::chrono::microseconds gap{0}; // Time since the previous message, or since the call started
+};
+
 /**
  * @brief Handler for gRPC protocol communications
  */
 class GrpcHandler final : public ProtocolHandler {
     Q_OBJECT
 public:
+    /**
+     * @brief Representation of request and response bodies
+     *
+     * JSON converts every message. BINARY encodes each distinct request body
+     * once and reuses it, and returns responses as raw protobuf bytes after
+     * checking the status and any field assertions; renderJson() converts a
+     * body when it actually needs to be shown.
+     */
+    enum class PayloadMode {
+        JSON,
+        BINARY
+    };
+
+    /**
+     * @brief Expected value of a scalar response field, checked in BINARY mode
+     */
+    struct FieldAssertion {
+        std::string path;      // Dotted field path, e.g. "status.code"
+        std::string expected;  // Text form; enums by name, bools as true/false, floats shortest (1.5)
+    };
+
+    /**
+     * @brief Services found through server reflection, not yet in use
+     */
+    struct Discovery {
+        std::shared_ptr<ChannelPool> channels;  // Pool the lookup went through
+        std::unique_ptr<ReflectionClient> reflection;
+        QStringList services;
+        std::optional<ReflectionClient::ServiceDescriptors> first;  // Of services.front(), prefetched
+    };
+    using DiscoveryTask = std::move_only_function<Discovery()>;
+
+    /**
+     * @brief Descriptors of one discovered service, fetched but not yet in use
+     */
+    struct ServiceFetch {
+        std::shared_ptr<ReflectionClient> reflection;  // Client of the discovery it belongs to
+        std::string service;
+        ReflectionClient::ServiceDescriptors descriptors;
+    };
+    using ServiceFetchTask = std::move_only_function<ServiceFetch()>;
+
+    using CallCallback = std::move_only_function<void(Expected<RequestResult>)>;
+    using StreamMessageCallback = std::function<void(const StreamMessage&)>;
+
     explicit GrpcHandler(QObject* parent = nullptr);
     ~GrpcHandler() override;
 
-    // Load proto file dynamically
+    /**
+     * @brief Load a .proto file, or a .pb/.desc/.protoset descriptor set
+     *
+     * Compiled .proto files are kept in the DescriptorCache, so reloading an
+     * unchanged file skips parsing. A descriptor set offers the services of
+     * all files it contains.
+     */
     void loadProtoFile(const std::string& path);
     
+    /**
+     * @brief Discover services through server reflection on the current endpoint
+     *
+     * Replaces the services of a loaded proto file. Descriptors of a service
+     * are fetched when it is selected with setService().
+     * @return Full names of the services
+     */
+    QStringList discoverServices();
+
+    /**
+     * @brief Split discovery so the network round trips leave the calling thread
+     *
+     * prepareDiscovery() captures the current endpoint; the task it returns
+     * blocks on the server and may run on any thread. adoptDiscovery() then
+     * switches to the found services on the handler's own thread, with the
+     * first one's descriptors already fetched.
+     * @throws Error from adoptDiscovery() if the endpoint changed meanwhile
+     */
+    DiscoveryTask prepareDiscovery();
+    QStringList adoptDiscovery(Discovery discovery);
+    
     // Get available services and methods
     QStringList getAvailableServices() const;
     QStringList getServiceMethods(const std::string& service) const;
     
     // Set current service and method
     void setService(const std::string& service);
+
+    /**
+     * @brief Split setService() for a discovered service whose descriptors are not fetched yet
+     *
+     * The task prepareServiceFetch() returns blocks on the server and may run
+     * on any thread; it is empty when setService() would not go to the server.
+     * adoptService() then selects the service on the handler's own thread.
+     * @throws Error from adoptService() if the endpoint changed meanwhile
+     */
+    ServiceFetchTask prepareServiceFetch(const std::string& service);
+    void adoptService(ServiceFetch fetch);
     void setMethod(const std::string& method);
     
-    // Configure endpoint
+    // Configure endpoint, a comma separated list spreads calls over several servers
     void setEndpoint(const std::string& endpoint);
     void setUseSSL(bool use_ssl);
+
+    /**
+     * @brief Channel count, load balancing, keepalive and compression
+     *
+     * Endpoints and TLS are taken from setEndpoint() and setUseSSL().
+     */
+    void setChannelOptions(ChannelPool::Options options);
+    const ChannelPool::Options& channelOptions() const { return m_channelOptions; }
     
     // Set auth metadata
     void setAuthMetadata(const QVariantList& headers);
 
+    // Payload handling, applied to calls started afterwards
+    void setPayloadMode(PayloadMode mode);
+    void setResponseAssertions(std::vector<FieldAssertion> assertions);
+    PayloadMode payloadMode() const { return m_payloadMode; }
+    const std::vector<FieldAssertion>& responseAssertions() const { return m_assertions; }
+
+    /**
+     * @brief Render a BINARY mode response body as JSON
+     * @param binary Serialized response message of the current method
+     */
+    Expected<std::string> renderJson(const std::string& binary) const;
+
     // ProtocolHandler interface
     RequestResult execute(const RequestConfig& config) override;
+    Expected<RequestResult> tryExecute(const RequestConfig& config) noexcept override;
     void cancel() override;
     std::future<RequestResult> executeAsync(const RequestConfig& config) override;
+    boost::asio::awaitable<RequestResult> co_execute(const RequestConfig& config) override;
+
+    /**
+     * @brief Start an asynchronous call on the shared completion queues
+     *
+     * Any number of calls may be in flight at once. Streaming methods go
+     * through PrepareCall; a client-streaming request body is a JSON array
+     * with one element per message.
+     * @param config Request configuration
+     * @param callback Invoked once with the result, on a completion queue thread
+     */
+    void startCall(const RequestConfig& config, CallCallback callback);
+
+    /**
+     * @brief Observe every message received on streaming calls
+     *
+     * Invoked on a completion queue thread. Set it before starting calls.
+     */
+    void setStreamMessageHandler(StreamMessageCallback callback);
+
+signals:
+    /**
+     * @brief Emitted for every message received on a streaming call
+     * @param message Message rendered as JSON, not emitted in BINARY payload mode
+     */
+    void streamMessageReceived(const QString& message);
 
 private:
     class ErrorCollector : public google::protobuf::compiler::MultiFileErrorCollector {
@@ -52,35 +202,61 @@ private:
                      const std::string& message) override;
     };
 
-    // Proto file handling
-    std::unique_ptr<google::protobuf::compiler::DiskSourceTree> m_source_tree;
-    std::unique_ptr<ErrorCollector> m_error_collector;
-    std::unique_ptr<google::protobuf::compiler::Importer> m_importer;
-    std::unique_ptr<google::protobuf::DynamicMessageFactory> m_message_factory;
+    // Loaded descriptors and their message factory, shared with call plans
+    struct DescriptorSource;
+    std::shared_ptr<const DescriptorSource> m_descriptors;
     
     // Service and method info
-    const google::protobuf::FileDescriptor* m_current_file{nullptr};
+    std::vector<const google::protobuf::FileDescriptor*> m_files;  // Files whose services are offered
+    std::shared_ptr<ReflectionClient> m_reflection;  // Set while services come from discovery, shared with fetches
+    QStringList m_discoveredServices;
     const google::protobuf::ServiceDescriptor* m_current_service{nullptr};
     const google::protobuf::MethodDescriptor* m_current_method{nullptr};
     
     // Channel configuration
     std::string m_endpoint{"localhost:50051"};
-    bool m_useSsl{false};
-    std::shared_ptr<grpc::Channel> m_channel;
-    std::unique_ptr<grpc::GenericStub> m_generic_stub;
+    ChannelPool::Options m_channelOptions{.endpoints = {"localhost:50051"}};
+    std::mutex m_channelMutex;
+    std::shared_ptr<ChannelPool> m_channels;  // Calls started from a pool keep its channels alive
     
     // Service method cache
     std::unordered_map<std::string, std::vector<std::string>> m_service_methods;
     
     // Auth headers for gRPC metadata
     std::vector<Header> m_auth_headers;
+
+    PayloadMode m_payloadMode{PayloadMode::JSON};
+    std::vector<FieldAssertion> m_assertions;
     
-    // Helper methods
-    void createChannel();
-    void executeMethod(const RequestConfig& config, RequestResult& result);
+    // Resolved by setMethod(), shared with the calls started from it
+    struct CallPlan;
+    mutable std::mutex m_planMutex;
+    std::shared_ptr<const CallPlan> m_plan;
 
-    std::string serializeRequest(const std::string& json_request);
-    std::string deserializeResponse(const google::protobuf::Message* response);
+    // Calls in flight, cancelled by cancel() and drained by the destructor
+    class Call;
+    class UnaryCall;
+    class StreamCall;
+    std::mutex m_callsMutex;
+    std::condition_variable m_callsDrained;
+    std::unordered_set<Call*> m_calls;
+
+    StreamMessageCallback m_streamMessageHandler;
+
+    // Helper methods
+    static google::protobuf::FileDescriptorSet compileProtoFile(const std::string& directory, const std::string& file);
+    void useDescriptors(const google::protobuf::FileDescriptorSet& descriptors, const std::vector<std::string>& roots);
+    const google::protobuf::ServiceDescriptor* findService(const std::string& service) const;
+    void resetChannels();
+    std::shared_ptr<ChannelPool> channels();
+    boost::asio::awaitable<RequestResult> awaitCall(RequestConfig config);
+    void rebuildPlan();
+    std::shared_ptr<const CallPlan> currentPlan() const;
+    static void addMetadata(grpc::ClientContext& context, const CallPlan& plan, const RequestConfig& config);
+    static Expected<std::vector<grpc::ByteBuffer>> encodeRequests(const CallPlan& plan, const std::string& body);
+    void deliverStreamMessage(const CallPlan& plan, const StreamMessage& message);
+    void trackCall(Call* call);
+    void finishCall(Call* call);
 };
 
 } // namespace flowdriver 
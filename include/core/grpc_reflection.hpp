@@ -0,0 +1,71 @@
+#pragma once
+
+#include <grpcpp/channel.h>
+#include <grpcpp/generic/generic_stub.h>
+#include <google/protobuf/descriptor.pb.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace flowdriver {
+
+namespace reflection {
+class ServerReflectionRequest;
+class ServerReflectionResponse;
+}
+
+/**
+ * @brief Service discovery through the gRPC Server Reflection protocol
+ *
+ * Speaks grpc.reflection.v1, falling back to v1alpha, over a generic stub.
+ * Descriptors are fetched lazily, only for the service being called, and
+ * kept per endpoint for the lifetime of the process. Each fetch re-requests
+ * the file defining the service; if it changed, the server was redeployed
+ * and everything cached for the endpoint is dropped.
+ */
+class ReflectionClient {
+public:
+    /**
+     * @brief Descriptors needed to call one service
+     */
+    struct ServiceDescriptors {
+        google::protobuf::FileDescriptorSet descriptors;  // Dependencies first
+        std::string file;                                 // File defining the service
+    };
+
+    /**
+     * @param channel Channel to the server
+     * @param endpoint Cache key, the address the channel was created for
+     */
+    ReflectionClient(std::shared_ptr<grpc::Channel> channel, std::string endpoint);
+    ~ReflectionClient();
+
+    ReflectionClient(const ReflectionClient&) = delete;
+    ReflectionClient& operator=(const ReflectionClient&) = delete;
+
+    /**
+     * @brief Full names of the services the server exposes
+     */
+    std::vector<std::string> listServices();
+
+    /**
+     * @brief Descriptors of a service and everything it depends on
+     * @param service Full service name as returned by listServices()
+     */
+    ServiceDescriptors fetchService(const std::string& service);
+
+private:
+    class Stream;
+    struct EndpointCache;
+
+    static std::shared_ptr<EndpointCache> cacheFor(const std::string& endpoint);
+    std::unique_ptr<Stream> open(const reflection::ServerReflectionRequest& request,
+                                 reflection::ServerReflectionResponse& response);
+
+    grpc::GenericStub m_stub;
+    std::string m_endpoint;
+    std::shared_ptr<EndpointCache> m_cache;
+    std::string m_method;  // Reflection version the server answered on
+};
+
+} // namespace flowdriver
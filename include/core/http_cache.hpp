@@ -0,0 +1,167 @@
+#pragma once
+
+#include "core/types.hpp"
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace flowdriver {
+
+/**
+ * @brief Cache-Control directives relevant to a private cache (RFC 9111, section 5.2)
+ */
+struct CacheControl {
+    bool no_store{false};
+    bool no_cache{false};
+    bool must_revalidate{false};
+    bool is_public{false};
+    bool is_private{false};
+    bool immutable{false};
+    std::optional<std::chrono::seconds> max_age;
+    std::optional<std::chrono::seconds> min_fresh;
+    std::optional<std::chrono::seconds> max_stale;  // Without an argument any staleness is accepted
+
+    /**
+     * @brief Parse a Cache-Control header value
+     * @param value Comma separated list of directives
+     */
+    static CacheControl parse(std::string_view value);
+};
+
+/**
+ * @brief Stored response together with the metadata needed for freshness checks
+ */
+struct CachedResponse {
+    int status_code{0};
+    std::vector<Header> headers;
+    std::string body;
+    std::vector<Header> vary;  // Request header values selected by the Vary header
+    std::chrono::system_clock::time_point request_time;
+    std::chrono::system_clock::time_point response_time;
+
+    std::size_t size() const;
+    std::optional<std::string> header(std::string_view name) const;
+    std::chrono::seconds currentAge(std::chrono::system_clock::time_point now) const;
+    std::chrono::seconds freshnessLifetime() const;
+    bool hasValidators() const;
+    RequestResult toResult(CacheStatus status) const;
+};
+
+/**
+ * @brief RFC 9111 aware HTTP response cache
+ *
+ * Keeps an in-memory LRU bounded by a byte budget and, optionally, a
+ * second tier on disk that survives restarts. Only GET responses are
+ * stored; stale entries with validators are revalidated with
+ * If-None-Match / If-Modified-Since and refreshed on 304.
+ */
+class HttpCache {
+public:
+    struct Options {
+        std::size_t memory_budget{64 * 1024 * 1024};  // Bytes kept in memory
+        std::optional<std::filesystem::path> disk_directory;  // Disk tier, disabled if empty
+    };
+
+    enum class LookupStatus {
+        MISS,   // Nothing usable stored
+        FRESH,  // Can be served without contacting the origin
+        STALE   // Stored, but must be revalidated first
+    };
+
+    struct Lookup {
+        LookupStatus status{LookupStatus::MISS};
+        std::shared_ptr<const CachedResponse> response;
+    };
+
+    struct Stats {
+        std::size_t hits{0};
+        std::size_t misses{0};
+        std::size_t revalidations{0};
+        std::size_t stores{0};
+        std::size_t evictions{0};
+        std::size_t entries{0};
+        std::size_t bytes{0};
+    };
+
+    HttpCache();
+    explicit HttpCache(Options options);
+    ~HttpCache();
+
+    HttpCache(const HttpCache&) = delete;
+    HttpCache& operator=(const HttpCache&) = delete;
+
+    /**
+     * @brief Find a stored response usable for the request
+     * @param request Outgoing request
+     */
+    Lookup lookup(const RequestConfig& request);
+
+    /**
+     * @brief Add If-None-Match / If-Modified-Since for a stale entry
+     * @param cached Entry being revalidated
+     * @param headers Request headers to extend
+     */
+    static void addConditionalHeaders(const CachedResponse& cached, std::vector<Header>& headers);
+
+    /**
+     * @brief Store a response if RFC 9111 allows it
+     * @param request Request that produced the response
+     * @param result Response received from the origin
+     * @param request_time Time the request was sent
+     * @param response_time Time the response was received
+     */
+    void store(const RequestConfig& request, const RequestResult& result,
+               std::chrono::system_clock::time_point request_time,
+               std::chrono::system_clock::time_point response_time);
+
+    /**
+     * @brief Refresh a stored entry from a 304 response and return the full response
+     * @param request Conditional request that was sent
+     * @param cached Entry that was revalidated
+     * @param not_modified The 304 response
+     */
+    RequestResult revalidated(const RequestConfig& request, const CachedResponse& cached,
+                              const RequestResult& not_modified,
+                              std::chrono::system_clock::time_point request_time,
+                              std::chrono::system_clock::time_point response_time);
+
+    /**
+     * @brief Drop the entry for the request target (used after unsafe methods)
+     */
+    void invalidate(const std::string& url);
+
+    void clear();
+    Stats stats() const;
+
+    static bool isCacheableMethod(std::string_view method);
+    static bool isUnsafeMethod(std::string_view method);
+
+private:
+    struct Entry {
+        std::shared_ptr<const CachedResponse> response;
+        std::list<std::string>::iterator lru;
+    };
+
+    void insert(const std::string& key, std::shared_ptr<const CachedResponse> response);
+    void evict();
+    std::filesystem::path diskPath(const std::string& key) const;
+    std::shared_ptr<const CachedResponse> loadFromDisk(const std::string& key) const;
+    void saveToDisk(const std::string& key, const CachedResponse& response) const;
+
+    Options m_options;
+    mutable std::mutex m_mutex;
+    std::list<std::string> m_lru;  // Most recently used first
+    std::unordered_map<std::string, Entry> m_entries;
+    std::size_t m_bytes{0};
+    Stats m_stats;
+};
+
+} // namespace flowdriver
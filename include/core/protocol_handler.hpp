@@ -4,6 +4,9 @@
 #include <QVariant>
 #include <QVariantList>
 #include "core/types.hpp"
+#include "core/error.hpp"
+#include "core/response_arena.hpp"
+#include <boost/asio/awaitable.hpp>
 #include <future>
 
 namespace flowdriver {
@@ -29,6 +32,41 @@ public:
      * @param config Request configuration
      */
     virtual RequestResult execute(const RequestConfig& config);
+
+    /**
+     * @brief Execute request synchronously without throwing
+     *
+     * Failures are returned as the Error alternative, which keeps hot loops
+     * such as benchmarks free of exception unwinding.
+     * @param config Request configuration
+     */
+    virtual Expected<RequestResult> tryExecute(const RequestConfig& config) noexcept;
+
+    /**
+     * @brief Execute request synchronously, placing the response in an arena
+     *
+     * The default implementation copies the result of tryExecute() into the
+     * arena; handlers that can read straight into it override this.
+     * @param config Request configuration
+     * @param arena Arena receiving headers and body, must outlive the result
+     */
+    virtual Expected<RawResult> tryExecuteRaw(const RequestConfig& config, ResponseArena& arena) noexcept;
+
+    /**
+     * @brief Execute request as a coroutine
+     *
+     * The default implementation runs execute() on the shared Executor and
+     * resumes the awaiting coroutine on its own executor. Handlers with a
+     * native asynchronous transport override it.
+     * @param config Request configuration
+     */
+    virtual boost::asio::awaitable<RequestResult> co_execute(const RequestConfig& config);
+
+    /**
+     * @brief Non-throwing counterpart of co_execute()
+     * @param config Request configuration
+     */
+    virtual boost::asio::awaitable<Expected<RequestResult>> co_tryExecute(const RequestConfig& config);
     
     /**
      * @brief Cancel ongoing request if possible
@@ -42,6 +80,13 @@ protected:
      * @throws Error if configuration is invalid
      */
     virtual void validateConfig(const RequestConfig& config);
+
+    /**
+     * @brief Await execute() running on a worker thread
+     * @param config Request configuration, copied into the coroutine frame
+     * @throws Error INVALID_STATE if the executor queue is full; never waits for space
+     */
+    boost::asio::awaitable<RequestResult> offloadExecute(RequestConfig config);
 };
 
 } // namespace flowdriver 
\ No newline at end of file
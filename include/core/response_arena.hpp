@@ -0,0 +1,144 @@
+#pragma once
+
+#include "core/types.hpp"
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace flowdriver {
+
+/**
+ * @brief Monotonic allocation arena for response data
+ *
+ * Everything allocated from the arena is released at once by reset(). The
+ * initial block is kept across resets, so a worker that reuses one arena
+ * per request performs no heap allocation once responses fit into it.
+ */
+class ResponseArena {
+public:
+    ResponseArena();
+    explicit ResponseArena(std::size_t initial_size);
+
+    ResponseArena(const ResponseArena&) = delete;
+    ResponseArena& operator=(const ResponseArena&) = delete;
+
+    /**
+     * @brief Memory resource backing the arena, for pmr containers
+     */
+    std::pmr::memory_resource* resource() { return &m_resource; }
+
+    /**
+     * @brief Copy bytes into the arena
+     * @return View of the copy, valid until reset()
+     */
+    std::string_view copy(std::string_view data);
+
+    /**
+     * @brief Construct an object inside the arena
+     *
+     * The destructor is never run, so T must not own memory outside the arena.
+     */
+    template<typename T, typename... Args>
+    T* create(Args&&... args) {
+        void* storage = m_resource.allocate(sizeof(T), alignof(T));
+        return ::new (storage) T(std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Release everything allocated since the last reset, keeping the initial block
+     */
+    void reset();
+
+    std::size_t initialSize() const { return m_initial.size(); }
+
+private:
+    std::vector<std::byte> m_initial;
+    std::pmr::monotonic_buffer_resource m_resource;
+};
+
+/**
+ * @brief Allocator drawing from a ResponseArena
+ *
+ * Unlike std::pmr::polymorphic_allocator it is assignable and propagates
+ * with its container, which Beast's header storage requires.
+ */
+template<typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    ArenaAllocator(ResponseArena& arena) noexcept : m_resource(arena.resource()) {}
+    explicit ArenaAllocator(std::pmr::memory_resource* resource) noexcept : m_resource(resource) {}
+
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : m_resource(other.resource()) {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(m_resource->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept {
+        m_resource->deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+    std::pmr::memory_resource* resource() const noexcept { return m_resource; }
+
+    template<typename U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept {
+        return m_resource == other.resource();
+    }
+
+private:
+    std::pmr::memory_resource* m_resource;
+};
+
+/**
+ * @brief Header whose name and value point into a ResponseArena
+ */
+struct HeaderView {
+    std::string_view name;
+    std::string_view value;
+};
+
+/**
+ * @brief Non-owning request result, all views point into a ResponseArena
+ *
+ * Valid until the arena is reset. Call materialize() to obtain an owning
+ * RequestResult when the data has to outlive the arena.
+ */
+struct RawResult {
+    explicit RawResult(ResponseArena& arena) : headers(arena.resource()) {}
+
+    int status_code{0};
+    std::pmr::vector<HeaderView> headers;
+    std::string_view body;
+    std::string_view error;
+    RequestMetrics metrics;
+    CacheStatus cache_status{CacheStatus::NONE};
+
+    /**
+     * @brief Case-insensitive header lookup
+     */
+    std::optional<std::string_view> header(std::string_view name) const;
+
+    /**
+     * @brief Copy the views into an owning result
+     */
+    RequestResult materialize() const;
+
+    /**
+     * @brief Copy an owning result into the arena
+     */
+    static RawResult fromResult(const RequestResult& result, ResponseArena& arena);
+};
+
+} // namespace flowdriver
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core/protocol_handler.hpp"
+#include "core/http_cache.hpp"
 #include <boost/beast/core.hpp>
 #include <boost/beast/http.hpp>
 #include <boost/beast/ssl.hpp>
@@ -28,6 +29,10 @@ public:
 
     std::future<RequestResult> executeAsync(const RequestConfig& config) override;
     RequestResult execute(const RequestConfig& config) override;
+    Expected<RequestResult> tryExecute(const RequestConfig& config) noexcept override;
+    Expected<RawResult> tryExecuteRaw(const RequestConfig& config, ResponseArena& arena) noexcept override;
+    boost::asio::awaitable<RequestResult> co_execute(const RequestConfig& config) override;
+    boost::asio::awaitable<Expected<RequestResult>> co_tryExecute(const RequestConfig& config) override;
     void cancel() override;
 
     // SSL configuration using Beast's SSL context
@@ -36,9 +41,19 @@ public:
     // Add connection pooling
     void setMaxConnections(size_t max_connections);
 
+    /**
+     * @brief Attach an HTTP response cache, nullptr disables caching
+     *
+     * May be called while requests are in flight; they finish with the cache
+     * they started with.
+     * @param cache Cache shared between handlers
+     */
+    void setCache(std::shared_ptr<HttpCache> cache);
+    std::shared_ptr<HttpCache> cache() const;
+
 private:
     class Impl;
-    std::unique_ptr<Impl> pimpl_;
+    std::shared_ptr<Impl> pimpl_;  // Shared with the coroutines of calls in flight
 };
 
 } // namespace flowdriver 
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <chrono>
+#include <memory>
 #include <optional>
 #include <variant>
 
@@ -16,6 +18,22 @@ struct Header {
     std::string value;
 };
 
+/**
+ * @brief One part of a multipart message, shared instead of copied
+ *
+ * The owner keeps the bytes alive, so a frame can be handed to the transport
+ * or passed on from a received message without copying the payload.
+ */
+struct Frame {
+    std::shared_ptr<const void> owner;
+    std::string_view data;
+
+    static Frame fromString(std::string bytes) {
+        auto owned = std::make_shared<const std::string>(std::move(bytes));
+        return Frame{owned, *owned};
+    }
+};
+
 enum class Protocol {
     REST,
     WEBSOCKET,
@@ -40,14 +58,23 @@ struct AuthConfig {
     std::string api_key_name;
 };
 
+enum class CacheStatus {
+    NONE,        // Cache not consulted
+    MISS,        // Fetched from the origin
+    HIT,         // Served from the cache
+    REVALIDATED  // Origin answered 304, stored body served
+};
+
 struct RequestConfig {
     Protocol protocol{Protocol::REST};
     std::string method;
     std::string url;
     std::vector<Header> headers;
     std::string body;
+    std::vector<Frame> frames;  // Multipart message (ZeroMQ), sent instead of body when set
     std::optional<AuthConfig> auth;
     std::chrono::milliseconds timeout{5000};
+    bool bypass_cache{false};
 };
 
 struct RequestMetrics {
@@ -58,14 +85,23 @@ struct RequestMetrics {
     std::chrono::microseconds first_byte_time{0};
     size_t bytes_sent{0};
     size_t bytes_received{0};
+
+    // Streaming calls
+    size_t messages_sent{0};
+    size_t messages_received{0};
+    std::chrono::microseconds first_message_time{0};  // Call start to first received message
+    std::chrono::microseconds max_message_gap{0};     // Longest wait between received messages
+    double messages_per_second{0.0};
 };
 
 struct RequestResult {
     int status_code{0};
     std::vector<Header> headers;
     std::string body;
+    std::vector<Frame> frames;  // Parts of a multipart reply (ZeroMQ), body holds the last one
     RequestMetrics metrics;
     std::string error;
+    CacheStatus cache_status{CacheStatus::NONE};
 };
 
 } // namespace flowdriver 
\ No newline at end of file
@@ -44,6 +44,12 @@ public:
      */
     RequestResult execute(const RequestConfig& config) override;
 
+    /**
+     * @brief Send message synchronously, reporting failures as a value
+     * @param config Request configuration
+     */
+    Expected<RequestResult> tryExecute(const RequestConfig& config) noexcept override;
+
     /**
      * @brief Close the WebSocket connection
      */
@@ -2,6 +2,7 @@
 
 #include "protocol_handler.hpp"
 #include "core/error.hpp"
+#include "core/zmq_capture.hpp"
 #include <zmq.hpp>
 #include <string_view>
 #include <memory>
@@ -10,10 +11,15 @@
 #include <QString>
 #include <QObject>
 #include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <future>
+#include <optional>
 #include <thread>
-#include <queue>
 #include <mutex>
 #include <map>
+#include <unordered_map>
 
 namespace flowdriver {
 
@@ -60,6 +66,95 @@ public:
         ERROR
     };
 
+    /**
+     * @brief Context and socket tuning, applied by configure()
+     *
+     * Options left at -1 keep the libzmq default.
+     */
+    struct SocketProfile {
+        int io_threads{1};              // Context I/O threads; changing it recreates the context
+        int send_hwm{1000};             // Messages queued per peer before PUB drops and others block
+        int receive_hwm{1000};
+        uint64_t affinity{0};           // Bitmask of I/O threads for new connections, 0 for any
+        bool immediate{true};           // Queue only to completed connections
+        int linger{0};                  // ms unsent messages are kept on close
+        int tcp_keepalive{-1};          // 1 on, 0 off
+        int tcp_keepalive_idle{-1};     // s
+        int tcp_keepalive_interval{-1}; // s
+        int tcp_keepalive_count{-1};
+        int send_buffer{-1};            // Kernel SO_SNDBUF bytes
+        int receive_buffer{-1};         // Kernel SO_RCVBUF bytes
+        bool conflate{false};           // Keep only the newest message, single-part messages only
+        int receive_batch{256};         // Messages read per readiness event
+        int timeout{-1};                // Send/receive timeout in ms, -1 keeps setTimeout()'s
+    };
+
+    /**
+     * @brief Request pipelining for DEALER
+     */
+    struct PipelineOptions {
+        std::size_t window{32};  // Requests awaiting a reply before further ones are held back
+        bool correlate{false};   // Prefix requests with a correlation frame the peer must echo
+    };
+
+    /**
+     * @brief How replay() paces the captured messages
+     */
+    enum class ReplayPacing {
+        ORIGINAL,  // Gaps as captured
+        SCALED,    // Gaps divided by speed
+        MAX        // As fast as the socket takes them
+    };
+
+    struct ReplayOptions {
+        ReplayPacing pacing{ReplayPacing::ORIGINAL};
+        double speed{1.0};  // SCALED only, 2.0 replays twice as fast
+    };
+
+    struct ReplayStats {
+        uint64_t messages{0};
+        uint64_t failed{0};
+        uint64_t bytes{0};
+        std::chrono::nanoseconds duration{0};
+        std::chrono::nanoseconds max_lag{0};  // Worst delay behind the captured schedule
+    };
+
+    /**
+     * @brief A socket serviced by the handler next to the configured one
+     */
+    struct SocketSpec {
+        std::string name;
+        Role role{Role::SUBSCRIBER};
+        std::string endpoint;                // Bound for PUBLISHER, PULLER, REPLIER and ROUTER
+        std::vector<std::string> topics;     // SUBSCRIBER only, empty for everything
+    };
+
+    /**
+     * @brief Traffic of one socket of the handler
+     */
+    struct SocketMetrics {
+        std::string name;  // Empty for the configured socket
+        Role role{Role::REQUESTER};
+        std::string endpoint;
+        uint64_t messagesReceived{0};
+        uint64_t messagesSent{0};
+        uint64_t bytesReceived{0};
+        uint64_t bytesSent{0};
+    };
+
+    /**
+     * @brief Traffic of one peer of a ROUTER
+     */
+    struct PeerStats {
+        std::string identity;
+        uint64_t messagesReceived{0};
+        uint64_t messagesSent{0};
+        uint64_t bytesReceived{0};
+        uint64_t bytesSent{0};
+        std::size_t queued{0};  // Replies waiting for the peer's pipe
+        uint64_t dropped{0};    // Replies given up on because the pipe stayed full
+    };
+
     static std::vector<Role> getAvailableRoles(const Pattern &pattern) {
         switch (pattern) {
             case Pattern::REQ_REP:
@@ -92,9 +187,7 @@ public:
      */
     template<typename T>
     void setOption(int option, const T& value) {
-        if (m_socket) {
-            m_socket->set(option, value);
-        }
+        invoke([option, value](zmq::socket_t& socket) { socket.set(option, value); });
     }
 
     /**
@@ -109,11 +202,106 @@ public:
      */
     void setTimeout(int timeout);
 
+    /**
+     * @brief Set the profile the next configure() applies
+     */
+    void setSocketProfile(const SocketProfile& profile) { m_profile = profile; }
+    const SocketProfile& socketProfile() const { return m_profile; }
+
+    /**
+     * @brief Apply the socket options of a profile
+     */
+    static void applyProfile(zmq::socket_t& socket, const SocketProfile& profile);
+
+    /**
+     * @brief Set the DEALER in-flight window and correlation
+     *
+     * Concurrent callers share the socket; up to window requests are on the
+     * wire at once. Replies answer the oldest request unless correlate is
+     * set, which adds a correlation frame the peer has to echo and matches
+     * replies by it. Leave it off for peers that do not echo the envelope,
+     * as it changes the wire format. REQ always uses a window of one.
+     */
+    void setPipeline(PipelineOptions options);
+
+    /**
+     * @brief Per-peer statistics of a ROUTER
+     */
+    std::vector<PeerStats> routerPeers();
+
+    /**
+     * @brief Record every received message to a capture file
+     *
+     * SUBSCRIBER, PULLER and ROUTER only; ROUTER records keep the sender's
+     * identity frame. An existing capture is continued.
+     * @throws Error for other roles or if the file cannot be opened
+     */
+    void startCapture(const std::string& path);
+    void stopCapture();
+
+    /**
+     * @brief Send the messages of a capture file
+     *
+     * PUBLISHER, PUSHER and DEALER only. Blocks until the capture is
+     * replayed or stopReplay() is called; captured identity frames are
+     * dropped since the socket sends under its own.
+     * @throws Error for other roles or if the file is not a capture
+     */
+    ReplayStats replay(const std::string& path, const ReplayOptions& options);
+    ReplayStats replay(const std::string& path) { return replay(path, ReplayOptions{}); }
+    void stopReplay() { m_replaying = false; }
+
+    /**
+     * @brief Send one message, large frames without copying
+     * @param more Further parts follow the frames
+     * @return false if the send failed or would block under ZMQ_DONTWAIT
+     */
+    static bool sendFrames(zmq::socket_t& socket, const std::vector<Frame>& frames, bool more = false,
+                           int flags = 0);
+
+    /**
+     * @brief Receive one message as frames viewing the received parts
+     * @return false if nothing was received
+     */
+    static bool receiveFrames(zmq::socket_t& socket, std::vector<Frame>& frames, int flags = 0);
+
+    /**
+     * @brief Open a further socket, polled together with the configured one
+     *
+     * Lets one handler drive a whole topology, such as a PUBLISHER and many
+     * SUBSCRIBERs. Received messages are counted, not shown; REPLIER and
+     * ROUTER sockets answer like the configured socket does. The sockets
+     * live until removed or the handler is reconfigured.
+     * @throws Error if the handler is not configured, the name is taken or
+     *         the endpoint cannot be bound or connected
+     */
+    void addSocket(const SocketSpec& spec);
+    void removeSocket(const std::string& name);
+
+    /**
+     * @brief Send messages on a socket added with addSocket()
+     *
+     * Never waits for the socket: sending stops at the first message that
+     * finds no peer or a full pipe.
+     * @return Messages sent before the first failure
+     * @throws Error if no socket has that name
+     */
+    std::size_t send(const std::string& name, const std::vector<std::vector<Frame>>& messages);
+    bool send(const std::string& name, const std::vector<Frame>& frames) {
+        return send(name, std::vector<std::vector<Frame>>{frames}) == 1;
+    }
+
+    /**
+     * @brief Traffic of the configured socket followed by the added ones
+     */
+    std::vector<SocketMetrics> socketMetrics();
+
     ConnectionStatus getConnectionStatus() const { return m_status; }
     std::string getLastError() const { return m_lastError; }
 
     std::future<RequestResult> executeAsync(const RequestConfig& config) override;
     RequestResult execute(const RequestConfig& config) override;
+    Expected<RequestResult> tryExecute(const RequestConfig& config) noexcept override;
     void cancel() override;
 
     void setConnectionStatus(ConnectionStatus status) {
@@ -142,64 +330,161 @@ private:
     void setupPUBSUB();
     void setupDEALERROUTER();
     void setCommonSocketOptions();
+    void createWakeup();
+    void resetContext(int io_threads);
+    // Runs on the poll thread with the socket, or with nullptr once it is gone
+    using SocketTask = std::move_only_function<void(zmq::socket_t* socket)>;
+
     void startPolling();
     void stopPolling();
-    bool sendMessage(const std::string& message, bool more = false);
+    void pollLoop();
+    void wake();
+    void unbindAndWait();
+    void post(SocketTask task);
+    void invoke(std::move_only_function<void(zmq::socket_t&)> fn);
+    void runTasks(zmq::socket_t* socket);
+    void sendRequest(zmq::socket_t& socket, std::vector<Frame> frames, bool multipart,
+                     std::promise<Expected<RequestResult>> reply);
+    void sendBacklog(zmq::socket_t& socket);
+    void sendUnsentReply(zmq::socket_t& socket);
+    bool completeReply(std::vector<Frame>& frames);
+    void expireReplies(bool closing);
+    void queueToPeer(const std::string& identity, std::vector<Frame> message);
+    void flushPeers(zmq::socket_t& socket);
+    static QString displayText(const std::vector<Frame>& frames);
+    static std::unexpected<Error> lastZmqError(const std::string& context);
     
     // Message handling methods
     void handleREQREPMessage();
     void handlePUBSUBMessage();
     void handlePUSHPULLMessage();
     void handleDEALERROUTERMessage();
-    void processIncomingMessage(const zmq::message_t& identity, zmq::message_t& message);
+    void handleRouterMessage(std::vector<Frame> frames);
+    void processIncomingMessage(const std::vector<Frame>& frames);
+    struct NamedSocket;
+    NamedSocket* findSocket(const std::string& name);
+    void handleNamedSocket(NamedSocket& named);
+    void captureFrames(const std::vector<Frame>& frames, bool routed);
+    void flushCapture();
     
-    static RequestResult createResult(const std::string& body, bool success = true) {
+    /**
+     * @brief Result carrying the message frames
+     * @param copyBody Also copy the last frame into body, for callers that sent a plain body
+     */
+    static RequestResult createResult(std::vector<Frame> frames, bool copyBody = true, bool success = true) {
         RequestResult result;
         result.status_code = success ? 200 : 500;
-        result.body = body;
         result.headers = {};
-        result.metrics.bytes_received = body.size();
+        for (const auto& frame : frames) {
+            result.metrics.bytes_received += frame.data.size();
+        }
+        if (copyBody && !frames.empty()) {
+            result.body = std::string(frames.back().data);
+        }
+        result.frames = std::move(frames);
         return result;
     }
     
+    // Performance metrics
+    struct Metrics {
+        std::atomic<uint64_t> messagesReceived{0};
+        std::atomic<uint64_t> messagesSent{0};
+        std::atomic<uint64_t> bytesReceived{0};
+        std::atomic<uint64_t> bytesSent{0};
+
+        void countReceived(std::size_t bytes) {
+            messagesReceived++;
+            bytesReceived += bytes;
+        }
+        void countSent(std::size_t bytes) {
+            messagesSent++;
+            bytesSent += bytes;
+        }
+        void reset() {
+            messagesReceived = 0;
+            messagesSent = 0;
+            bytesReceived = 0;
+            bytesSent = 0;
+        }
+    };
+
+    struct NamedSocket {
+        SocketSpec spec;
+        zmq::socket_t socket;
+        Metrics metrics;
+        std::optional<std::vector<Frame>> unsentReply;  // Waits for POLLOUT, nothing is read meanwhile
+    };
+
     // ZMQ context and socket
     zmq::context_t m_context{1};
+    int m_ioThreads{1};
     std::unique_ptr<zmq::socket_t> m_socket;
+
+    // Inproc PAIR that interrupts the poll thread's blocking poll
+    zmq::socket_t m_wakeSender;
+    zmq::socket_t m_wakeReceiver;
+    std::mutex m_wakeMutex;
     
     // Configuration
     Pattern m_pattern{Pattern::REQ_REP};
     Role m_role{Role::REQUESTER};
     std::string m_endpoint;
     int m_timeout{500};
+    SocketProfile m_profile;
+    int m_receiveBatch{256};  // Copied from the profile, read by the poll thread
     
-    // Thread management
+    // Thread management; while running only the poll thread touches m_socket
     std::atomic<bool> m_running{false};
     std::unique_ptr<std::thread> m_pollThread;
+
+    // Work for the poll thread, drained in batches per wakeup
+    std::mutex m_taskMutex;
+    std::deque<SocketTask> m_tasks;
+    bool m_wakePending{false};
+
+    struct PendingReply {
+        std::promise<Expected<RequestResult>> reply;
+        std::chrono::steady_clock::time_point deadline;
+        std::optional<std::vector<Frame>> on_timeout;  // Result frames when no reply is acceptable
+        bool multipart{false};                          // Caller wants frames only, no body copy
+    };
+    struct QueuedRequest {
+        std::vector<Frame> frames;
+        bool multipart{false};
+        std::promise<Expected<RequestResult>> reply;
+        std::chrono::steady_clock::time_point deadline;  // Fails with TIMEOUT if still unsent
+    };
+    // Poll thread only; ids grow with every send, so the first entry is the oldest
+    std::map<uint64_t, PendingReply> m_pendingReplies;
+    std::deque<QueuedRequest> m_backlog;  // Requests waiting for a writable socket or a free window slot
+    bool m_sendBlocked{false};             // The backlog hit a full pipe, poll for POLLOUT
+    std::optional<std::vector<Frame>> m_unsentReply;  // REPLIER reply waiting for POLLOUT
+    uint64_t m_nextCorrelation{0};
+    PipelineOptions m_pipeline;
     
     // Router/Dealer specific settings
     std::string m_dealerId;  // Unique identifier for DEALER socket
     std::string m_identity;  // Store last received identity for ROUTER responses
     
-    // Router queues
-    std::map<std::string, std::queue<std::string>> m_routerQueues;  // Message queues per client
-    std::mutex m_routerQueuesMutex;
-    
-    struct QueuedMessage {
-        std::string message;
-        std::chrono::steady_clock::time_point timestamp;
-        bool requiresResponse;
+    // Capture of received traffic, poll thread only
+    std::unique_ptr<CaptureWriter> m_capture;
+    std::atomic<bool> m_replaying{false};
+
+    // ROUTER routing table, poll thread only
+    struct Peer {
+        std::deque<std::vector<Frame>> outbox;  // Complete messages, identity frame first
+        PeerStats stats;
+        std::optional<std::chrono::steady_clock::time_point> blockedSince;  // Pipe full since
     };
-    
-    std::queue<QueuedMessage> m_outgoingQueue;
-    std::mutex m_queueMutex;
-    
-    // Performance metrics
-    struct Metrics {
-        std::atomic<uint64_t> messagesReceived{0};
-        std::atomic<uint64_t> messagesSent{0};
-        std::atomic<uint64_t> bytesReceived{0};
-        std::atomic<uint64_t> bytesSent{0};
-    } m_metrics;
+    std::unordered_map<std::string, Peer> m_peers;
+    std::deque<std::string> m_readyPeers;  // Peers with queued messages, served round robin
+    std::chrono::milliseconds m_flushRetry{1};  // Grows while no peer takes a message
+
+    // Sockets added with addSocket(), poll thread only while it runs
+    std::vector<std::unique_ptr<NamedSocket>> m_sockets;
+    bool m_socketsChanged{false};  // Poll items must be rebuilt
+
+    Metrics m_metrics;
 };
 
 } // namespace flowdriver 
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "core/types.hpp"
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace flowdriver {
+
+/**
+ * @brief Appends received ZeroMQ messages to a capture file
+ *
+ * The file is a short header followed by records laid out back to back:
+ *
+ *     int64  timestamp    ns since the Unix epoch at receipt
+ *     uint32 flags        bit 0: first frame is the sender's routing identity
+ *     uint32 frame count
+ *     per frame: uint32 size, then the bytes
+ *
+ * Integers are in host byte order. Records are only ever appended, so
+ * reopening an existing capture continues it. Writes go through a buffer
+ * that is written out once it fills or kFlushInterval after the previous
+ * write, whichever comes first; a crash loses what is still buffered.
+ * Owners call flushIfDue() while idle so a quiet socket does not hold
+ * records back, or flush() to make them visible to readers right away.
+ */
+class CaptureWriter {
+public:
+    static constexpr std::chrono::milliseconds kFlushInterval{200};
+
+    /**
+     * @brief Open or continue a capture
+     * @throws Error if the file cannot be opened or is not a capture
+     */
+    explicit CaptureWriter(const std::string& path);
+    ~CaptureWriter();
+
+    CaptureWriter(const CaptureWriter&) = delete;
+    CaptureWriter& operator=(const CaptureWriter&) = delete;
+
+    /**
+     * @throws Error if writing fails
+     */
+    void append(std::int64_t timestamp_ns, const std::vector<Frame>& frames, bool routed);
+    void flush();
+
+    /**
+     * @brief Write out buffered records older than kFlushInterval
+     * @throws Error if writing fails
+     */
+    void flushIfDue();
+    bool buffered() const { return !m_buffer.empty(); }
+
+    std::uint64_t records() const { return m_records; }
+
+private:
+    std::string m_path;
+    std::ofstream m_out;
+    std::string m_buffer;
+    std::chrono::steady_clock::time_point m_lastFlush{std::chrono::steady_clock::now()};
+    std::uint64_t m_records{0};
+};
+
+/**
+ * @brief Reads a capture file through a memory mapping
+ *
+ * Frames point into the mapping and keep it alive, so records are handed
+ * out without copying message bytes. A record cut short by a crash ends
+ * the capture.
+ */
+class CaptureReader {
+public:
+    struct Record {
+        std::int64_t timestamp_ns{0};
+        bool routed{false};  // frames.front() is the captured sender's identity
+        std::vector<Frame> frames;
+    };
+
+    /**
+     * @throws Error if the file cannot be mapped or is not a capture
+     */
+    explicit CaptureReader(const std::string& path);
+
+    std::optional<Record> next();
+    void rewind();
+
+    /**
+     * @brief Byte offset of the next record, the end of the last complete one
+     */
+    std::size_t position() const { return m_offset; }
+
+private:
+    struct Mapping;
+
+    std::shared_ptr<const Mapping> m_mapping;
+    std::size_t m_offset{0};
+};
+
+} // namespace flowdriver
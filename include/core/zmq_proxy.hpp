@@ -0,0 +1,158 @@
+#pragma once
+
+#include "core/zeromq_handler.hpp"
+#include "core/zmq_capture.hpp"
+#include <zmq.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace flowdriver {
+
+/**
+ * @brief Forwarding device between real ZeroMQ producers and consumers
+ *
+ * Forwards between a frontend and a backend on its own thread, steered
+ * like zmq::proxy_steerable through PAUSE, RESUME and TERMINATE on a
+ * control socket. Both sides keep talking to each other as before, only
+ * their endpoints point at the proxy. The loop is our own rather than
+ * libzmq's so every message is known to travel upstream or downstream:
+ * it counts both directions, and copies each message tagged with its
+ * direction to a capture socket. The capture reader pairs requests with
+ * replies and, if configured, appends publications or requests to a
+ * capture file in the format replayed by ZeroMQHandler::replay(). The
+ * capture socket drops copies it cannot keep up with, so observing never
+ * slows forwarding.
+ */
+class ZmqProxy {
+public:
+    enum class Kind {
+        XPUB_XSUB,     // Publishers connect to the frontend, subscribers to the backend
+        ROUTER_DEALER  // Clients connect to the frontend, workers to the backend
+    };
+
+    enum class State {
+        STOPPED,
+        RUNNING,
+        PAUSED  // Messages stay queued in the sockets until resumed
+    };
+
+    struct Config {
+        Kind kind{Kind::XPUB_XSUB};
+        std::string frontend{"tcp://*:5559"};  // Bound
+        std::string backend{"tcp://*:5560"};   // Bound
+        ZeroMQHandler::SocketProfile profile;  // Applied to the context and both sides
+        std::string capture_path;              // Empty to only measure
+    };
+
+    struct Direction {
+        uint64_t messages{0};
+        uint64_t bytes{0};
+    };
+
+    struct Stats {
+        Direction frontend_to_backend;  // Publications or requests
+        Direction backend_to_frontend;  // Subscriptions or replies
+        uint64_t captured{0};           // Messages seen on the capture socket
+        uint64_t recorded{0};           // Of those, written to the capture file
+
+        // ROUTER_DEALER: request to reply through the proxy, for clients whose requests
+        // carry ZeroMQHandler's correlation frame; other requests give no round trip
+        uint64_t round_trips{0};
+        std::chrono::nanoseconds round_trip_min{0};
+        std::chrono::nanoseconds round_trip_mean{0};
+        std::chrono::nanoseconds round_trip_max{0};
+
+        std::chrono::nanoseconds elapsed{0};  // Since start(), pauses included
+    };
+
+    explicit ZmqProxy(Config config);
+    ~ZmqProxy();
+
+    ZmqProxy(const ZmqProxy&) = delete;
+    ZmqProxy& operator=(const ZmqProxy&) = delete;
+
+    /**
+     * @brief Bind both sides and start forwarding
+     * @throws Error if an endpoint cannot be bound or the capture file opened
+     */
+    void start();
+
+    void pause();
+    void resume();
+
+    /**
+     * @brief Stop forwarding and close both sides, blocks until done
+     */
+    void terminate();
+
+    State state() const { return m_state; }
+
+    /**
+     * @brief Forwarding counters and what the capture saw
+     */
+    Stats stats();
+
+private:
+    // Direction frame leading every capture copy
+    enum class Flow : char {
+        UPSTREAM = 'u',   // Frontend to backend
+        DOWNSTREAM = 'd'  // Backend to frontend
+    };
+
+    struct Counters {
+        std::atomic<uint64_t> messages{0};
+        std::atomic<uint64_t> bytes{0};
+    };
+
+    void sendCommand(const char* command);
+    void forwardLoop();
+    void forward(zmq::socket_t& from, zmq::socket_t& to, Flow flow, Counters& counters);
+    void captureLoop();
+    void trackRoundTrip(Flow flow, const std::vector<Frame>& frames, std::chrono::steady_clock::time_point seen);
+
+    Config m_config;
+    std::atomic<State> m_state{State::STOPPED};
+
+    // Declared before the sockets, which must close first
+    zmq::context_t m_context;
+    zmq::socket_t m_frontend;
+    zmq::socket_t m_backend;
+
+    // Written by the proxy thread
+    Counters m_upstream;
+    Counters m_downstream;
+
+    // Inproc pairs: proxy side moves to the proxy thread, the other stays here
+    zmq::socket_t m_captureOut;
+    zmq::socket_t m_captureIn;
+    zmq::socket_t m_controlOut;
+    zmq::socket_t m_controlIn;
+    std::mutex m_controlMutex;
+
+    std::thread m_proxyThread;
+    std::thread m_captureThread;
+    std::atomic<bool> m_capturing{false};
+    std::chrono::steady_clock::time_point m_started;
+    Stats m_lastStats;  // Kept once terminated
+
+    // Capture thread only, except under m_statsMutex
+    std::unique_ptr<CaptureWriter> m_writer;
+    std::mutex m_statsMutex;
+    uint64_t m_captured{0};
+    uint64_t m_recorded{0};
+    uint64_t m_roundTrips{0};
+    std::chrono::nanoseconds m_roundTripMin{std::chrono::nanoseconds::max()};
+    std::chrono::nanoseconds m_roundTripMax{0};
+    std::chrono::nanoseconds m_roundTripTotal{0};
+    // Requests awaiting their reply, by client identity and correlation frame
+    std::unordered_map<std::string, std::chrono::steady_clock::time_point> m_outstanding;
+};
+
+} // namespace flowdriver
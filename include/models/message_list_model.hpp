@@ -0,0 +1,85 @@
+#pragma once
+
+#include <QAbstractListModel>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <atomic>
+#include <deque>
+#include "core/mpmc_queue.hpp"
+
+namespace flowdriver::ui {
+
+/**
+ * @brief Message log shown by the streaming views
+ *
+ * Receive threads hand messages over through post(), which only pushes
+ * into a lock-free ring. The GUI thread drains the ring at most once per
+ * frame and inserts the whole batch with one row insertion, so message
+ * rate no longer translates into GUI events. Only the newest maxHistory
+ * rows are kept. Messages that find the ring full are dropped and
+ * counted rather than blocking the receiver. latestReceived carries the
+ * newest received message of each batch for views that show only one.
+ */
+class MessageListModel : public QAbstractListModel {
+    Q_OBJECT
+    Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+    Q_PROPERTY(int maxHistory READ maxHistory WRITE setMaxHistory NOTIFY maxHistoryChanged)
+    Q_PROPERTY(quint64 dropped READ dropped NOTIFY statsChanged)
+    Q_PROPERTY(quint64 evicted READ evicted NOTIFY statsChanged)
+
+public:
+    enum Roles {
+        DirectionRole = Qt::UserRole + 1,
+        MessageRole,
+        TimestampRole
+    };
+
+    explicit MessageListModel(QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    /**
+     * @brief Queue a message for display, callable from any thread
+     */
+    void post(const QString& direction, const QString& message);
+
+    Q_INVOKABLE void append(const QString& direction, const QString& message) { post(direction, message); }
+    Q_INVOKABLE void clear();
+
+    int maxHistory() const { return m_maxHistory; }
+    void setMaxHistory(int maxHistory);
+
+    quint64 dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+    quint64 evicted() const { return m_evicted; }
+
+signals:
+    void countChanged();
+    void maxHistoryChanged();
+    void statsChanged();
+    void latestReceived(const QString& message);
+
+private:
+    struct Message {
+        QString direction;
+        QString text;
+        qint64 timestamp{0};  // ms since epoch, taken when posted
+    };
+
+    void flush();
+    void trim();
+
+    MpmcQueue<Message> m_incoming;
+    std::atomic<bool> m_flushScheduled{false};
+    std::atomic<quint64> m_dropped{0};
+    QTimer m_flushTimer;
+
+    // GUI thread only
+    std::deque<Message> m_messages;
+    int m_maxHistory{5000};
+    quint64 m_evicted{0};
+};
+
+} // namespace flowdriver::ui
@@ -2,20 +2,23 @@
 
 #include <QObject>
 #include <QVariantMap>
+#include <exception>
+#include <future>
 #include <memory>
 #include "core/protocol_handler.hpp"
 #include "core/types.hpp"
 #include "models/auth_model.hpp"
+#include "models/message_list_model.hpp"
+#include <atomic>
 #include <core/zeromq_handler.hpp>
 #include <core/rest_handler.hpp>
 #include <core/websocket_handler.hpp>
 #include <core/grpc_handler.hpp>
+#include <core/zmq_proxy.hpp>
+#include <testing/zmq_benchmark.hpp>
 
 namespace flowdriver::ui {
 
-#define COMPLETION_TIMEOUT 2000
-#define CHECK_REQUEST_TIMEOUT 500
-
 class RequestManager : public QObject {
     Q_OBJECT
     Q_PROPERTY(bool isLoading READ isLoading NOTIFY loadingChanged)
@@ -27,10 +30,13 @@ class RequestManager : public QObject {
     Q_PROPERTY(QString grpcEndpoint READ getGrpcEndpoint WRITE setGrpcEndpoint NOTIFY grpcEndpointChanged)
     Q_PROPERTY(bool grpcUseSSL READ getGrpcUseSSL WRITE setGrpcUseSSL NOTIFY grpcUseSSLChanged)
     Q_PROPERTY(QString protoFilePath READ getProtoFilePath WRITE setProtoFilePath NOTIFY protoFilePathChanged)
+    Q_PROPERTY(bool httpCacheEnabled READ isHttpCacheEnabled WRITE setHttpCacheEnabled NOTIFY httpCacheChanged)
+    Q_PROPERTY(QString httpCacheDirectory READ getHttpCacheDirectory WRITE setHttpCacheDirectory NOTIFY httpCacheChanged)
+    Q_PROPERTY(MessageListModel* messages READ getMessages CONSTANT)
 
 public:
     explicit RequestManager(QObject* parent = nullptr);
-    ~RequestManager() = default;
+    ~RequestManager() override;
 
     RequestManager(const RequestManager&) = delete;
     RequestManager& operator=(const RequestManager&) = delete;
@@ -42,6 +48,7 @@ public:
     bool isConnected() const { return m_isConnected; }
     AuthModel* getAuthModel() const { return m_authModel; }
     void setAuthModel(AuthModel* model);
+    MessageListModel* getMessages() const { return m_messages; }
 
     bool validateRestRequest(const QString& method, const QString& url);
 
@@ -64,8 +71,94 @@ public:
      */
     Q_INVOKABLE void connectZMQ(const QString& endpoint, const QString& pattern, const QString& role);
 
+    /**
+     * @brief Context and socket tuning for ZeroMQ
+     *
+     * Applied by the next connectZMQ() and startZmqProxy().
+     * @param options Any of ioThreads, sendHwm, receiveHwm, affinity, immediate,
+     *        linger, tcpKeepalive, tcpKeepaliveIdle, tcpKeepaliveInterval,
+     *        tcpKeepaliveCount, sendBuffer, receiveBuffer, conflate,
+     *        receiveBatch and timeout; missing keys keep their value
+     */
+    Q_INVOKABLE void setZmqSocketProfile(const QVariantMap& options);
+
+    /**
+     * @brief Open a further socket on the connected ZeroMQ handler
+     * @param spec name, role and endpoint, plus topics for a SUBSCRIBER
+     */
+    Q_INVOKABLE void addZmqSocket(const QVariantMap& spec);
+    Q_INVOKABLE void removeZmqSocket(const QString& name);
+
+    /**
+     * @brief Send one message on a socket added with addZmqSocket()
+     * @return False if the socket had no peer or a full pipe
+     */
+    Q_INVOKABLE bool sendOnZmqSocket(const QString& name, const QString& message);
+
+    /**
+     * @brief Traffic of the connected socket followed by the added ones, one map each
+     */
+    Q_INVOKABLE QVariantList zmqSocketMetrics();
+
+    /**
+     * @brief Record what the connected SUBSCRIBER, PULLER or ROUTER receives to a capture file
+     */
+    Q_INVOKABLE void startZmqCapture(const QString& path);
+    Q_INVOKABLE void stopZmqCapture();
+
+    /**
+     * @brief Send a capture file on the connected PUBLISHER, PUSHER or DEALER
+     *
+     * Runs on the executor; zmqReplayFinished or errorOccurred follows.
+     * @param options Any of pacing (ORIGINAL, SCALED, MAX) and speed
+     */
+    Q_INVOKABLE void replayZmqCapture(const QString& path, const QVariantMap& options);
+    Q_INVOKABLE void stopZmqReplay();
+
+    /**
+     * @brief Measure latency or throughput of a ZeroMQ pattern within this process
+     *
+     * Runs on the executor with the profile of setZmqSocketProfile();
+     * zmqBenchmarkFinished or errorOccurred follows.
+     * @param options Any of pattern (REQ-REP, PUB-SUB, PUSH-PULL, DEALER-ROUTER),
+     *        mode (LATENCY, THROUGHPUT), endpoint, messageSize, messageCount
+     *        and receiveTimeoutMs; missing keys keep the ZmqBenchmark defaults
+     */
+    Q_INVOKABLE void runZmqBenchmark(const QVariantMap& options);
+    Q_INVOKABLE void stopZmqBenchmark();
+
+    /**
+     * @brief Start a forwarding proxy between ZeroMQ producers and consumers
+     * @param options Any of kind (XPUB_XSUB, ROUTER_DEALER), frontend, backend
+     *        and capturePath; missing keys keep the ZmqProxy defaults
+     */
+    Q_INVOKABLE void startZmqProxy(const QVariantMap& options);
+    Q_INVOKABLE void pauseZmqProxy();
+    Q_INVOKABLE void resumeZmqProxy();
+    Q_INVOKABLE void stopZmqProxy();
+
+    /**
+     * @brief Forwarding counters of the running proxy, or of the last one once stopped
+     */
+    Q_INVOKABLE QVariantMap zmqProxyStats();
+
     Q_INVOKABLE void loadGrpcProtoFile(const QString& path);
+
+    /**
+     * @brief Discover services of the gRPC endpoint through server reflection
+     *
+     * Runs on the executor; grpcServicesChanged or errorOccurred follows
+     * once the server answered. A newer call supersedes a pending one.
+     */
+    Q_INVOKABLE void discoverGrpcServices();
     Q_INVOKABLE QStringList getGrpcMethods(const QString& service);
+
+    /**
+     * @brief Select a gRPC service
+     *
+     * A discovered service's descriptors are fetched on the executor the
+     * first time; grpcMethodsChanged or errorOccurred follows.
+     */
     Q_INVOKABLE void setGrpcService(const QString& service);
     Q_INVOKABLE void setGrpcMethod(const QString& method);
 
@@ -76,9 +169,31 @@ public:
     void setGrpcEndpoint(const QString& endpoint);
     void setGrpcUseSSL(bool use);
 
+    /**
+     * @brief Configure the gRPC channel pool
+     * @param options Any of channels, loadBalancing (PICK_FIRST, ROUND_ROBIN),
+     *        keepaliveMs, keepaliveTimeoutMs, keepaliveWithoutCalls and
+     *        compression (NONE, DEFLATE, GZIP); missing keys keep their value
+     */
+    Q_INVOKABLE void setGrpcChannelOptions(const QVariantMap& options);
+
     QString getProtoFilePath() const { return m_protoFilePath; }
     void setProtoFilePath(const QString& path);
 
+    /**
+     * @brief Turn the REST response cache on or off, stored entries are kept
+     */
+    bool isHttpCacheEnabled() const { return m_httpCacheEnabled; }
+    void setHttpCacheEnabled(bool enabled);
+
+    /**
+     * @brief Directory of the cache's disk tier, empty keeps the cache in memory only
+     *
+     * Changing it starts a new cache; entries stored so far are dropped.
+     */
+    QString getHttpCacheDirectory() const { return m_httpCacheDirectory; }
+    void setHttpCacheDirectory(const QString& directory);
+
     Q_INVOKABLE void clearMessages();
 
 public slots:
@@ -96,6 +211,7 @@ signals:
     void protocolChanged();
     void currentRoleChanged();
     void responseReceived(const QVariantMap& result);
+    void latestMessageReceived(const QVariantMap& result);  // Newest logged stream message, for the viewer
     void errorOccurred(const QString& error);
     void messageSent(const QString& message);
     void messageReceived(const QString& message);
@@ -104,17 +220,26 @@ signals:
     void connectionStatusChanged();
     void authModelChanged();
     void grpcServicesChanged();
+    void grpcMethodsChanged(const QString& service, const QStringList& methods);
     void grpcEndpointChanged();
     void grpcUseSSLChanged();
+    void zmqProxyStateChanged(const QString& state);
+    void zmqReplayFinished(const QVariantMap& stats);
+    void zmqBenchmarkFinished(const QVariantMap& result);
     void protoFilePathChanged();
+    void httpCacheChanged();
     void exportRequested(const QString& format, const QVariantMap& response);
     void exportCompleted();
     void messagesCleared();
 
 private:
     void initializeProtocolHandler();
+    void createGrpcHandler();
     RequestConfig prepareConfig(const QString& method, const QString& url, const QVariantList& headers, const QString& body);
-    void checkRequest();
+    void completeRequest(quint64 requestId, std::exception_ptr error, RequestResult result);
+    void completeDiscovery(quint64 discoveryId, Expected<GrpcHandler::Discovery> discovery);
+    void completeServiceFetch(quint64 fetchId, Expected<GrpcHandler::ServiceFetch> fetch);
+    void updateGrpcMethods(const QString& service);
 
     ZeroMQHandler::Pattern convertPattern(const QString& pattern) {
         if (pattern == "REQ-REP") return ZeroMQHandler::Pattern::REQ_REP;
@@ -136,6 +261,57 @@ private:
         throw Error(ErrorCode::INVALID_CONFIG, "Invalid ZeroMQ role");
     }
 
+    static QString zmqRoleName(ZeroMQHandler::Role role) {
+        switch (role) {
+            case ZeroMQHandler::Role::REQUESTER: return "REQUESTER";
+            case ZeroMQHandler::Role::REPLIER: return "REPLIER";
+            case ZeroMQHandler::Role::PUBLISHER: return "PUBLISHER";
+            case ZeroMQHandler::Role::SUBSCRIBER: return "SUBSCRIBER";
+            case ZeroMQHandler::Role::PUSHER: return "PUSHER";
+            case ZeroMQHandler::Role::PULLER: return "PULLER";
+            case ZeroMQHandler::Role::DEALER: return "DEALER";
+            case ZeroMQHandler::Role::ROUTER: return "ROUTER";
+        }
+        return {};
+    }
+
+    ZeroMQHandler::ReplayPacing convertReplayPacing(const QString& pacing) {
+        if (pacing == "ORIGINAL") return ZeroMQHandler::ReplayPacing::ORIGINAL;
+        if (pacing == "SCALED") return ZeroMQHandler::ReplayPacing::SCALED;
+        if (pacing == "MAX") return ZeroMQHandler::ReplayPacing::MAX;
+        throw Error(ErrorCode::INVALID_CONFIG, "Invalid replay pacing");
+    }
+
+    testing::ZmqBenchmarkMode convertBenchmarkMode(const QString& mode) {
+        if (mode == "LATENCY") return testing::ZmqBenchmarkMode::LATENCY;
+        if (mode == "THROUGHPUT") return testing::ZmqBenchmarkMode::THROUGHPUT;
+        throw Error(ErrorCode::INVALID_CONFIG, "Invalid ZeroMQ benchmark mode");
+    }
+
+    ZmqProxy::Kind convertProxyKind(const QString& kind) {
+        if (kind == "XPUB_XSUB") return ZmqProxy::Kind::XPUB_XSUB;
+        if (kind == "ROUTER_DEALER") return ZmqProxy::Kind::ROUTER_DEALER;
+        throw Error(ErrorCode::INVALID_CONFIG, "Invalid ZeroMQ proxy kind");
+    }
+
+    ChannelPool::LoadBalancing convertLoadBalancing(const QString& policy) {
+        if (policy == "PICK_FIRST") return ChannelPool::LoadBalancing::PICK_FIRST;
+        if (policy == "ROUND_ROBIN") return ChannelPool::LoadBalancing::ROUND_ROBIN;
+        throw Error(ErrorCode::INVALID_CONFIG, "Invalid gRPC load balancing policy");
+    }
+
+    ChannelPool::Compression convertCompression(const QString& compression) {
+        if (compression == "NONE") return ChannelPool::Compression::NONE;
+        if (compression == "DEFLATE") return ChannelPool::Compression::DEFLATE;
+        if (compression == "GZIP") return ChannelPool::Compression::GZIP;
+        throw Error(ErrorCode::INVALID_CONFIG, "Invalid gRPC compression");
+    }
+
+    // Roles whose incoming ZeroMQ traffic is shown, the others only echo what they sent
+    static bool showsReceivedMessages(const QString& role) {
+        return role == "REPLIER" || role == "SUBSCRIBER" || role == "PULLER" || role == "ROUTER";
+    }
+
     // Helper to convert RequestResult to QVariantMap
     static QVariantMap convertResultToVariantMap(const RequestResult& result) {
         QVariantMap response;
@@ -159,9 +335,17 @@ private:
     QString m_currentProtocol{"REST"};
     QString m_currentRole{"DEALER"};
     ProtocolHandler* m_handler{nullptr};
-    std::future<RequestResult> m_currentRequest;
+    quint64 m_requestId{0};  // Identifies the REST request whose completion is expected
     std::unique_ptr<ZeroMQHandler> m_zmqHandler;
+    std::unique_ptr<ZmqProxy> m_zmqProxy;  // Independent of the protocol in use
+    std::future<void> m_zmqReplay;  // Replay running on the executor, uses m_zmqHandler
+    ZeroMQHandler::SocketProfile m_zmqProfile;  // Kept across handler re-creation
+    testing::ZmqBenchmark m_zmqBenchmark;
+    std::future<void> m_zmqBenchmarkRun;  // Benchmark running on the executor
     std::unique_ptr<RestHandler> m_restHandler;
+    std::shared_ptr<HttpCache> m_httpCache;  // Outlives REST handler re-creation
+    bool m_httpCacheEnabled{true};
+    QString m_httpCacheDirectory;
     std::unique_ptr<WebSocketHandler> m_wsHandler;
     bool m_isConnected{false};
     AuthModel* m_authModel{nullptr};
@@ -170,16 +354,24 @@ private:
 
     void handleZMQMessage(const std::string& message);
     void handleZMQError(const QString& error);
+    void releaseZmqHandler();
+    void finishZmqBenchmark();
 
     QStringList m_grpcServices;
+    quint64 m_discoveryId{0};  // Identifies the discovery whose result is expected
+    quint64 m_serviceFetchId{0};  // Likewise for the descriptors of a selected service
     QString m_grpcEndpoint{"localhost:50051"};
     bool m_grpcUseSSL{false};
+    ChannelPool::Options m_grpcChannelOptions;  // Kept across handler re-creation
     QString m_currentGrpcService;
     QString m_currentGrpcMethod;
     QMap<QString, QStringList> m_grpcServiceMethods;
 
     QString m_protoFilePath;
 
+    MessageListModel* m_messages{nullptr};
+    std::atomic<bool> m_zmqShowsReceived{false};  // Read on the ZeroMQ poll thread
+
 private slots:
     void onWebSocketConnected() {
         m_isConnected = true;
@@ -44,6 +44,7 @@ private:
 private:
     int m_statusCode{0};
     QString m_body;
+    QString m_formattedBody;
     QVariantList m_headers;
     QVariantList m_cookies;
     QString m_error;
@@ -1,10 +1,44 @@
 #pragma once
 
 #include <chrono>
+#include <optional>
+#include <vector>
+#include "core/grpc_handler.hpp"
 #include "core/types.hpp"
 
 namespace flowdriver::testing {
 
+/**
+ * @brief HTTP cache behaviour during a benchmark
+ */
+enum class CacheMode {
+    COLD,  // Every request bypasses the cache and reaches the origin
+    WARM   // Cache is primed before measuring, requests may be served from it
+};
+
+/**
+ * @brief How concurrent users are simulated
+ */
+enum class ExecutionMode {
+    THREADS,     // One blocking thread per user
+    COROUTINES   // One coroutine per user, multiplexed on the shared I/O pool
+};
+
+/**
+ * @brief gRPC handler settings in force while a benchmark runs
+ *
+ * The handler's own settings are restored afterwards. Ignored when the
+ * benchmarked handler is not a GrpcHandler.
+ */
+struct GrpcBenchmarkOptions {
+    // BINARY skips the JSON conversion of every request and response
+    GrpcHandler::PayloadMode payload_mode{GrpcHandler::PayloadMode::BINARY};
+    // BINARY only, a response failing one counts as a failed request
+    std::vector<GrpcHandler::FieldAssertion> assertions;
+    // Channel count, load balancing, keepalive and compression; endpoints and TLS stay the handler's
+    std::optional<ChannelPool::Options> channel;
+};
+
 /**
  * @brief Configuration for benchmark execution
  */
@@ -12,12 +46,17 @@ struct BenchmarkConfig {
     RequestConfig request;               // Request configuration to benchmark
     int concurrent_users{1};             // Number of concurrent users
     std::chrono::seconds duration{1};    // Duration of the benchmark
+    CacheMode cache_mode{CacheMode::COLD}; // Cold or warm HTTP cache
+    ExecutionMode execution_mode{ExecutionMode::THREADS}; // Threads or coroutines per user
+    GrpcBenchmarkOptions grpc;           // gRPC payload handling
 };
 
 struct BenchmarkMetrics {
     std::size_t total_requests{0};
     std::size_t successful_requests{0};
     std::size_t failed_requests{0};
+    std::size_t cache_hits{0};           // Served from cache or revalidated with 304
+    std::size_t stream_messages{0};      // Messages received on streaming calls
     double requests_per_second{0.0};
     std::chrono::system_clock::time_point start_time;
     std::chrono::system_clock::time_point end_time;
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <future>
+#include <boost/asio/awaitable.hpp>
 #include "core/protocol_handler.hpp"
 #include "testing/benchmark_config.hpp"
 
@@ -17,7 +19,25 @@ public:
     void stop();
 
 private:
+    struct Counters {
+        std::atomic<size_t> success{0};
+        std::atomic<size_t> errors{0};
+        std::atomic<size_t> cache_hits{0};
+        std::atomic<size_t> stream_messages{0};
+    };
+
+    // What the counters need from a result, failed requests leave status_code at 0
+    struct Outcome {
+        int status_code{0};
+        CacheStatus cache_status{CacheStatus::NONE};
+        size_t stream_messages{0};
+    };
+
     void validateConfig(const BenchmarkConfig& config);
+    void runThreads(const BenchmarkConfig& config, const RequestConfig& request, Counters& counters);
+    void runCoroutines(const BenchmarkConfig& config, const RequestConfig& request, Counters& counters);
+    boost::asio::awaitable<void> runUser(const RequestConfig& request, Counters& counters);
+    static void record(const Outcome& outcome, Counters& counters);
 
     ProtocolHandler* handler_;
     std::atomic<bool> is_running_{false};
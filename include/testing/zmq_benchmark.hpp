@@ -0,0 +1,121 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <string>
+#include <vector>
+#include "core/zeromq_handler.hpp"
+
+namespace flowdriver::testing {
+
+/**
+ * @brief Latency distribution with logarithmic buckets
+ *
+ * Eight buckets per power of two keep the error of any reported value
+ * below 12.5% while recording stays a constant-time array increment.
+ */
+class LatencyHistogram {
+public:
+    struct Bucket {
+        std::chrono::nanoseconds upper;  // Largest latency counted in the bucket
+        std::size_t count;
+    };
+
+    void record(std::chrono::nanoseconds latency);
+
+    std::size_t count() const { return count_; }
+    std::chrono::nanoseconds min() const;
+    std::chrono::nanoseconds max() const { return max_; }
+    std::chrono::nanoseconds mean() const;
+
+    /**
+     * @brief Latency below which the given share of samples fall
+     * @param percentile 0 to 100
+     */
+    std::chrono::nanoseconds percentile(double percentile) const;
+
+    /**
+     * @brief Buckets holding at least one sample, shortest first
+     */
+    std::vector<Bucket> buckets() const;
+
+private:
+    static constexpr int kSubBucketBits = 3;
+    static constexpr std::size_t kBucketCount = 64 << kSubBucketBits;
+
+    static std::size_t bucketIndex(std::uint64_t nanoseconds);
+    static std::uint64_t bucketUpper(std::size_t index);
+
+    std::array<std::size_t, kBucketCount> counts_{};
+    std::size_t count_{0};
+    std::chrono::nanoseconds min_{std::chrono::nanoseconds::max()};
+    std::chrono::nanoseconds max_{0};
+    std::chrono::nanoseconds total_{0};
+};
+
+/**
+ * @brief What a ZeroMQ benchmark measures
+ */
+enum class ZmqBenchmarkMode {
+    LATENCY,    // One message in flight at a time, like local_lat/remote_lat
+    THROUGHPUT  // Sender runs flat out on its own thread, like local_thr/remote_thr
+};
+
+struct ZmqBenchmarkConfig {
+    ZeroMQHandler::Pattern pattern{ZeroMQHandler::Pattern::PUSH_PULL};
+    ZmqBenchmarkMode mode{ZmqBenchmarkMode::THROUGHPUT};
+    std::string endpoint{"tcp://127.0.0.1:5555"};  // tcp://127.0.0.1, ipc:// or inproc://
+    std::size_t message_size{64};                    // Bytes, includes the 24 byte stamp
+    std::size_t message_count{100000};
+    ZeroMQHandler::SocketProfile profile;            // Applied to the context and both sockets
+    std::chrono::milliseconds receive_timeout{1000};  // Silence after which the rest counts as lost
+};
+
+struct ZmqBenchmarkResult {
+    std::size_t messages_sent{0};
+    std::size_t messages_received{0};
+    std::size_t messages_lost{0};        // Sent but never received
+    std::size_t messages_reordered{0};   // Received after a higher sequence number
+    double messages_per_second{0.0};
+    double bytes_per_second{0.0};
+    LatencyHistogram one_way;            // Send to receipt
+    LatencyHistogram round_trip;         // Send to reply, REQ-REP and DEALER-ROUTER only
+    ZeroMQHandler::SocketProfile profile;  // Settings the numbers were measured with
+    std::chrono::system_clock::time_point start_time;
+    std::chrono::system_clock::time_point end_time;
+};
+
+/**
+ * @brief Built-in latency and throughput benchmark for the ZeroMQ patterns
+ *
+ * Both ends run in this process on a private context: the receiving socket
+ * binds, the sending one connects. Every message starts with a sequence
+ * number and the send time on the steady clock, so one-way latency, loss
+ * and reordering are measured without a second clock. REQ-REP cannot
+ * pipeline, its throughput is that of back-to-back round trips.
+ */
+class ZmqBenchmark {
+public:
+    ZmqBenchmark() = default;
+    ~ZmqBenchmark();
+
+    ZmqBenchmarkResult run(const ZmqBenchmarkConfig& config);
+    std::future<ZmqBenchmarkResult> runAsync(const ZmqBenchmarkConfig& config);
+    void stop();
+
+private:
+    struct Sockets;
+
+    void validateConfig(const ZmqBenchmarkConfig& config);
+    bool warmUp(Sockets& sockets);  // False if stopped first, Error(TIMEOUT) if never connected
+    void runLatency(Sockets& sockets, ZmqBenchmarkResult& result);
+    void runThroughput(Sockets& sockets, ZmqBenchmarkResult& result);
+
+    std::atomic<bool> is_running_{false};
+};
+
+} // namespace flowdriver::testing
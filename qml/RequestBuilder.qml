@@ -26,14 +26,14 @@ Rectangle {
     property string currentPattern: "REQ-REP"
     property string currentRole: "REQUESTER"
 
-    // Messages model
-    ListModel { id: messagesModel }
+    // Messages model, filled in batches by RequestManager
+    readonly property MessageListModel messagesModel: requestManager.messages
 
     // File dialog for proto files
     FileDialog {
         id: protoFileDialog
         title: "Select Proto File"
-        nameFilters: ["Proto files (*.proto)"]
+        nameFilters: ["Proto files (*.proto)", "Descriptor sets (*.pb *.desc *.protoset)"]
         onAccepted: {
             let path = selectedFile.toString()
             // Handle both Windows and Unix paths
@@ -518,7 +518,8 @@ Rectangle {
                             Label {
                                 anchors.top: parent.top
                                 anchors.right: parent.right
-                                text: "Messages: " + messagesListView.count
+                                text: "Messages: " + messagesListView.count +
+                                      (messagesModel.dropped > 0 ? "  Dropped: " + messagesModel.dropped : "")
                                 z: 1
                             }
 
@@ -603,70 +604,47 @@ Rectangle {
     // Add connections to handle responses
     Connections {
         target: requestManager
+
+        function onGrpcMethodsChanged(service, methods) {
+            if (serviceCombo.currentText === service) {
+                grpcMethodCombo.model = methods
+                if (methods.length > 0) {
+                    grpcMethodCombo.currentIndex = 0
+                }
+            }
+        }
         
         function onResponseReceived(result) {
             logMessage("Response", JSON.stringify(result))
             if (protocolCombo.currentText === "REST") {
                 // Handle REST response display
             } else {
-                messagesModel.append({
-                    direction: "Received",
-                    message: result.body,
-                    timestamp: new Date().toLocaleTimeString()
-                })
+                messagesModel.append("Received", result.body)
             }
         }
 
         function onMessageReceived(message) {
-            console.log("QML received message:", message);
-            logMessage("Received", message);
-            
-            // Queue the update on the main thread
-            messageUpdateTimer.pendingMessage = {
-                direction: "Received",
-                message: message,
-                timestamp: new Date().toLocaleTimeString()
-            }
-            messageUpdateTimer.start()
+            messagesModel.append("Received", message)
         }
 
         function onMessageSent(message) {
             logMessage("Sent", message);
-            
-            // Queue the update on the main thread
-            messageUpdateTimer.pendingMessage = {
-                direction: "Sent",
-                message: message,
-                timestamp: new Date().toLocaleTimeString()
-            }
-            messageUpdateTimer.start()
+            messagesModel.append("Sent", message)
         }
 
         function onErrorOccurred(error) {
             logMessage("Error", error);
-            messagesModel.append({
-                direction: "Error",
-                message: error,
-                timestamp: new Date().toLocaleTimeString()
-            })
+            messagesModel.append("Error", error)
         }
 
         function onConnected() {
             logMessage("System", "Connected to " + urlField.text);
-            messagesModel.append({
-                direction: "System",
-                message: "Connected to " + urlField.text,
-                timestamp: new Date().toLocaleTimeString()
-            })
+            messagesModel.append("System", "Connected to " + urlField.text)
         }
 
         function onDisconnected() {
             logMessage("System", "Disconnected");
-            messagesModel.append({
-                direction: "System",
-                message: "Disconnected",
-                timestamp: new Date().toLocaleTimeString()
-            })
+            messagesModel.append("System", "Disconnected")
         }
 
         function onMessagesCleared() {
@@ -701,21 +679,6 @@ Rectangle {
         console.log(`[${new Date().toISOString()}] ${type}: ${message}`);
     }
 
-    // Add this to handle message updates on the main thread
-    Timer {
-        id: messageUpdateTimer
-        interval: 1  // Update as soon as possible
-        repeat: false
-        property var pendingMessage: null
-        
-        onTriggered: {
-            if (pendingMessage) {
-                messagesModel.append(pendingMessage)
-                pendingMessage = null
-            }
-        }
-    }
-
     // Add a loading overlay
     Rectangle {
         id: loadingOverlay
@@ -69,6 +69,9 @@ ApplicationWindow {
         onResponseReceived: function(result) {
             responseModel.updateResponse(result);
         }
+        onLatestMessageReceived: function(result) {
+            responseModel.updateResponse(result);
+        }
         onErrorOccurred: function(error) {
             // Show error notification
         }
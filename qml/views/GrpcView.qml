@@ -10,7 +10,7 @@ ColumnLayout {
     FileDialog {
         id: protoFileDialog
         title: "Select Protocol Buffer File"
-        nameFilters: ["Protocol Buffer Files (*.proto)"]
+        nameFilters: ["Protocol Buffer Files (*.proto)", "Descriptor Sets (*.pb *.desc *.protoset)"]
         currentFolder: StandardPaths.standardLocations(StandardPaths.HomeLocation)[0]
         onAccepted: {
             requestManager.setProtoFilePath(selectedFile)
@@ -57,13 +57,20 @@ ColumnLayout {
             checked: requestManager.grpcUseSSL
             onCheckedChanged: requestManager.grpcUseSSL = checked
         }
+
+        Button {
+            text: "Discover"
+            ToolTip.visible: hovered
+            ToolTip.text: "List services through server reflection"
+            onClicked: requestManager.discoverGrpcServices()
+        }
     }
 
     // Service selection
     ComboBox {
         Layout.fillWidth: true
         model: requestManager.availableGrpcServices
-        enabled: requestManager.protoFilePath !== ""
+        enabled: requestManager.availableGrpcServices.length > 0
         onCurrentTextChanged: requestManager.setGrpcService(currentText)
     }
 
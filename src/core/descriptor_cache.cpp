@@ -0,0 +1,184 @@
+#include "core/descriptor_cache.hpp"
+#include <openssl/evp.h>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <QDebug>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+namespace flowdriver {
+
+namespace {
+    constexpr char kDiskMagic[] = "FDDC1";
+
+    std::optional<std::string> readFile(const std::filesystem::path& path) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            return std::nullopt;
+        }
+        return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    void writeString(std::ostream& out, std::string_view value) {
+        std::uint64_t size = value.size();
+        out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        out.write(value.data(), static_cast<std::streamsize>(value.size()));
+    }
+
+    bool readString(std::istream& in, std::string& value) {
+        std::uint64_t size = 0;
+        if (!in.read(reinterpret_cast<char*>(&size), sizeof(size))) {
+            return false;
+        }
+        value.resize(size);
+        return static_cast<bool>(in.read(value.data(), static_cast<std::streamsize>(size)));
+    }
+}
+
+DescriptorCache::DescriptorCache() : DescriptorCache(Options{}) {}
+
+DescriptorCache::DescriptorCache(Options options)
+    : m_options(std::move(options))
+{
+    if (m_options.directory.empty()) {
+        // Per user, unlike the shared temp directory where others could plant entries
+        auto cache = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+        if (cache.isEmpty()) {
+            qDebug() << "Descriptor cache disabled: no cache location";
+            m_enabled = false;
+            return;
+        }
+        m_options.directory = std::filesystem::path(cache.toStdString()) / "descriptors";
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(m_options.directory, ec);
+    if (!ec) {
+        std::filesystem::permissions(m_options.directory, std::filesystem::perms::owner_all,
+                                     std::filesystem::perm_options::replace, ec);
+    }
+    if (ec) {
+        qDebug() << "Descriptor cache disabled:" << QString::fromStdString(ec.message());
+        m_enabled = false;
+    }
+}
+
+DescriptorCache& DescriptorCache::instance() {
+    static DescriptorCache cache;
+    return cache;
+}
+
+std::string DescriptorCache::sha256(std::string_view data) {
+    std::array<unsigned char, EVP_MAX_MD_SIZE> digest{};
+    unsigned int length = 0;
+    EVP_Digest(data.data(), data.size(), digest.data(), &length, EVP_sha256(), nullptr);
+
+    std::string hex;
+    hex.reserve(length * 2);
+    for (unsigned int i = 0; i < length; ++i) {
+        char byte[3];
+        std::snprintf(byte, sizeof(byte), "%02x", digest[i]);
+        hex.append(byte, 2);
+    }
+    return hex;
+}
+
+std::optional<std::string> DescriptorCache::entryKey(const std::filesystem::path& proto_file) const {
+    auto content = readFile(proto_file);
+    if (!content) {
+        return std::nullopt;
+    }
+    std::error_code ec;
+    auto absolute = std::filesystem::absolute(proto_file, ec).lexically_normal();
+    return sha256(absolute.string() + '\0' + *content);
+}
+
+std::filesystem::path DescriptorCache::entryPath(const std::string& key) const {
+    return m_options.directory / (key + ".desc");
+}
+
+std::optional<google::protobuf::FileDescriptorSet> DescriptorCache::load(
+    const std::filesystem::path& proto_file, const std::filesystem::path& source_root) const
+{
+    if (!m_enabled) {
+        return std::nullopt;
+    }
+    auto key = entryKey(proto_file);
+    if (!key) {
+        return std::nullopt;
+    }
+
+    std::ifstream in(entryPath(*key), std::ios::binary);
+    if (!in) {
+        return std::nullopt;
+    }
+
+    char magic[sizeof(kDiskMagic)] = {};
+    std::uint64_t sources = 0;
+    if (!in.read(magic, sizeof(magic)) || std::string_view(magic) != kDiskMagic ||
+        !in.read(reinterpret_cast<char*>(&sources), sizeof(sources))) {
+        return std::nullopt;
+    }
+
+    // Every import must still hash to what it was compiled from
+    for (std::uint64_t i = 0; i < sources; ++i) {
+        std::string name;
+        std::string digest;
+        if (!readString(in, name) || !readString(in, digest)) {
+            return std::nullopt;
+        }
+        auto content = readFile(source_root / name);
+        if (!content || sha256(*content) != digest) {
+            qDebug() << "Descriptor cache: stale entry, changed import" << QString::fromStdString(name);
+            return std::nullopt;
+        }
+    }
+
+    std::string serialized;
+    google::protobuf::FileDescriptorSet descriptors;
+    if (!readString(in, serialized) || !descriptors.ParseFromString(serialized)) {
+        return std::nullopt;
+    }
+    return descriptors;
+}
+
+void DescriptorCache::store(const std::filesystem::path& proto_file, const std::filesystem::path& source_root,
+                            const google::protobuf::FileDescriptorSet& descriptors) const
+{
+    if (!m_enabled) {
+        return;
+    }
+    auto key = entryKey(proto_file);
+    if (!key) {
+        return;
+    }
+
+    std::ostringstream out;
+    out.write(kDiskMagic, sizeof(kDiskMagic));
+    std::uint64_t sources = descriptors.file_size();
+    out.write(reinterpret_cast<const char*>(&sources), sizeof(sources));
+    for (const auto& file : descriptors.file()) {
+        auto content = readFile(source_root / file.name());
+        writeString(out, file.name());
+        writeString(out, content ? sha256(*content) : std::string());
+    }
+    writeString(out, descriptors.SerializeAsString());
+    auto entry = std::move(out).str();
+
+    // QSaveFile writes to a uniquely named file beside the entry and renames it on commit,
+    // so neither readers nor other processes storing the same key see a partial entry
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto path = QString::fromStdString(entryPath(*key).string());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) ||
+        file.write(entry.data(), static_cast<qint64>(entry.size())) != static_cast<qint64>(entry.size()) ||
+        !file.commit()) {
+        qDebug() << "Descriptor cache: cannot store" << path << ":" << file.errorString();
+    }
+}
+
+} // namespace flowdriver
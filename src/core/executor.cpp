@@ -0,0 +1,217 @@
+#include "core/executor.hpp"
+#include "core/error.hpp"
+#include <algorithm>
+#include <QDebug>
+
+namespace flowdriver {
+
+namespace {
+    thread_local const Executor* t_owner = nullptr;
+    thread_local std::size_t t_workerIndex = 0;
+}
+
+Executor::Executor() : Executor(Options{}) {}
+
+Executor::Executor(Options options)
+    : m_options(options)
+{
+    if (m_options.worker_threads == 0) {
+        m_options.worker_threads = std::max(2u, std::thread::hardware_concurrency());
+    }
+    m_options.io_threads = std::max<std::size_t>(1, m_options.io_threads);
+    m_options.queue_capacity = std::max<std::size_t>(1, m_options.queue_capacity);
+
+    for (std::size_t i = 0; i < m_options.worker_threads; ++i) {
+        m_queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (std::size_t i = 0; i < m_options.worker_threads; ++i) {
+        m_workers.emplace_back([this, i]() { workerLoop(i); });
+    }
+
+    for (std::size_t i = 0; i < m_options.io_threads; ++i) {
+        m_ioContexts.push_back(std::make_unique<boost::asio::io_context>(1));
+        m_ioGuards.push_back(boost::asio::make_work_guard(*m_ioContexts.back()));
+    }
+    for (auto& ioc : m_ioContexts) {
+        m_ioThreads.emplace_back([&ioc]() { ioc->run(); });
+    }
+
+    qDebug() << "Executor started with" << m_options.worker_threads << "workers and"
+             << m_options.io_threads << "I/O threads";
+}
+
+Executor::~Executor() {
+    {
+        std::lock_guard<std::mutex> lock(m_waitMutex);
+        m_stopping = true;
+    }
+    m_workAvailable.notify_all();
+    m_spaceAvailable.notify_all();
+
+    for (auto& worker : m_workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    m_ioGuards.clear();
+    for (auto& ioc : m_ioContexts) {
+        ioc->stop();
+    }
+    for (auto& thread : m_ioThreads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+Executor& Executor::instance() {
+    static Executor executor;
+    return executor;
+}
+
+bool Executor::isWorkerThread() const {
+    return t_owner == this;
+}
+
+void Executor::post(Task task) {
+    std::unique_lock<std::mutex> lock(m_waitMutex);
+    if (m_stopping) {
+        throw Error(ErrorCode::INVALID_STATE, "Executor is shutting down");
+    }
+
+    if (m_pending >= m_options.queue_capacity) {
+        if (isWorkerThread()) {
+            // Waiting here could starve the pool; apply backpressure by running inline
+            lock.unlock();
+            task();
+            ++m_completed;
+            return;
+        }
+
+        ++m_waits;
+        m_spaceAvailable.wait(lock, [this]() {
+            return m_pending < m_options.queue_capacity || m_stopping;
+        });
+        if (m_stopping) {
+            throw Error(ErrorCode::INVALID_STATE, "Executor is shutting down");
+        }
+    }
+
+    enqueue(std::move(task));
+    lock.unlock();
+    m_workAvailable.notify_one();
+}
+
+bool Executor::tryPost(Task task) {
+    std::unique_lock<std::mutex> lock(m_waitMutex);
+    if (m_stopping || m_pending >= m_options.queue_capacity) {
+        ++m_rejected;
+        return false;
+    }
+
+    enqueue(std::move(task));
+    lock.unlock();
+    m_workAvailable.notify_one();
+    return true;
+}
+
+// Called with m_waitMutex held
+void Executor::enqueue(Task task) {
+    std::size_t index = isWorkerThread()
+        ? t_workerIndex
+        : m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+
+    {
+        std::lock_guard<std::mutex> queue_lock(m_queues[index]->mutex);
+        m_queues[index]->tasks.push_back(std::move(task));
+    }
+    ++m_pending;
+}
+
+bool Executor::popTask(std::size_t index, Task& task) {
+    bool found = false;
+
+    {
+        // Own queue first, oldest task first
+        auto& own = *m_queues[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.front());
+            own.tasks.pop_front();
+            found = true;
+        }
+    }
+
+    // Steal from the back of the other queues
+    for (std::size_t i = 1; !found && i < m_queues.size(); ++i) {
+        auto& victim = *m_queues[(index + i) % m_queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.back());
+            victim.tasks.pop_back();
+            found = true;
+            ++m_stolen;
+        }
+    }
+
+    if (found) {
+        {
+            std::lock_guard<std::mutex> lock(m_waitMutex);
+            --m_pending;
+        }
+        m_spaceAvailable.notify_one();
+    }
+    return found;
+}
+
+void Executor::workerLoop(std::size_t index) {
+    t_owner = this;
+    t_workerIndex = index;
+
+    while (true) {
+        Task task;
+        if (popTask(index, task)) {
+            ++m_busy;
+            try {
+                task();
+            } catch (const std::exception& e) {
+                qDebug() << "Executor task failed:" << e.what();
+            }
+            --m_busy;
+            ++m_completed;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_waitMutex);
+        m_workAvailable.wait(lock, [this]() { return m_pending > 0 || m_stopping; });
+        if (m_stopping && m_pending == 0) {
+            return;
+        }
+    }
+}
+
+boost::asio::io_context& Executor::ioContext() {
+    auto index = m_nextIoContext.fetch_add(1, std::memory_order_relaxed) % m_ioContexts.size();
+    return *m_ioContexts[index];
+}
+
+Executor::Metrics Executor::metrics() const {
+    Metrics metrics;
+    metrics.worker_threads = m_options.worker_threads;
+    metrics.io_threads = m_options.io_threads;
+    metrics.queue_capacity = m_options.queue_capacity;
+    {
+        std::lock_guard<std::mutex> lock(m_waitMutex);
+        metrics.queue_depth = m_pending;
+    }
+    metrics.busy_workers = m_busy.load();
+    metrics.utilisation = static_cast<double>(metrics.busy_workers) / metrics.worker_threads;
+    metrics.tasks_completed = m_completed.load();
+    metrics.tasks_stolen = m_stolen.load();
+    metrics.tasks_rejected = m_rejected.load();
+    metrics.submit_waits = m_waits.load();
+    return metrics;
+}
+
+} // namespace flowdriver
@@ -0,0 +1,133 @@
+#include "core/grpc_channel_pool.hpp"
+#include "core/error.hpp"
+#include <grpcpp/create_channel.h>
+#include <grpcpp/security/credentials.h>
+#include <grpcpp/support/channel_arguments.h>
+#include <algorithm>
+#include <QDebug>
+
+namespace flowdriver {
+
+namespace {
+    std::string_view trim(std::string_view value) {
+        auto begin = value.find_first_not_of(" \t");
+        if (begin == std::string_view::npos) {
+            return {};
+        }
+        auto end = value.find_last_not_of(" \t");
+        return value.substr(begin, end - begin + 1);
+    }
+
+    bool isIpv4Literal(std::string_view endpoint) {
+        auto host = endpoint.substr(0, endpoint.rfind(':'));
+        return !host.empty() && std::ranges::count(host, '.') == 3 &&
+               std::ranges::all_of(host, [](char c) { return (c >= '0' && c <= '9') || c == '.'; });
+    }
+
+    bool isIpv6Literal(std::string_view endpoint) {
+        return endpoint.starts_with('[');
+    }
+
+    std::string join(const std::vector<std::string>& values) {
+        std::string joined;
+        for (const auto& value : values) {
+            if (!joined.empty()) {
+                joined += ',';
+            }
+            joined += value;
+        }
+        return joined;
+    }
+
+    grpc_compression_algorithm toAlgorithm(ChannelPool::Compression compression) {
+        switch (compression) {
+        case ChannelPool::Compression::DEFLATE: return GRPC_COMPRESS_DEFLATE;
+        case ChannelPool::Compression::GZIP: return GRPC_COMPRESS_GZIP;
+        default: return GRPC_COMPRESS_NONE;
+        }
+    }
+}
+
+ChannelPool::ChannelPool(Options options)
+    : m_options(std::move(options))
+{
+    if (m_options.endpoints.empty()) {
+        throw Error(ErrorCode::INVALID_CONFIG, "No gRPC endpoint configured");
+    }
+
+    auto credentials = m_options.use_ssl
+        ? grpc::SslCredentials(grpc::SslCredentialsOptions())
+        : grpc::InsecureChannelCredentials();
+
+    auto channel_targets = targets();
+    auto count = std::max(m_options.channels, channel_targets.size());
+    for (std::size_t i = 0; i < count; ++i) {
+        grpc::ChannelArguments args;
+        args.SetInt(GRPC_ARG_MAX_RECEIVE_MESSAGE_LENGTH, -1);
+        args.SetInt(GRPC_ARG_MAX_SEND_MESSAGE_LENGTH, -1);
+
+        // Without this, channels with equal arguments share their connections
+        args.SetInt(GRPC_ARG_USE_LOCAL_SUBCHANNEL_POOL, 1);
+        args.SetLoadBalancingPolicyName(
+            m_options.load_balancing == LoadBalancing::ROUND_ROBIN ? "round_robin" : "pick_first");
+
+        if (m_options.keepalive_time.count() > 0) {
+            args.SetInt(GRPC_ARG_KEEPALIVE_TIME_MS, static_cast<int>(m_options.keepalive_time.count()));
+            args.SetInt(GRPC_ARG_KEEPALIVE_TIMEOUT_MS, static_cast<int>(m_options.keepalive_timeout.count()));
+            args.SetInt(GRPC_ARG_KEEPALIVE_PERMIT_WITHOUT_CALLS, m_options.keepalive_without_calls ? 1 : 0);
+            args.SetInt(GRPC_ARG_HTTP2_MAX_PINGS_WITHOUT_DATA, 0);
+        }
+        if (m_options.compression != Compression::NONE) {
+            args.SetCompressionAlgorithm(toAlgorithm(m_options.compression));
+        }
+
+        Member member;
+        member.channel = grpc::CreateCustomChannel(channel_targets[i % channel_targets.size()], credentials, args);
+        member.stub = std::make_unique<grpc::GenericStub>(member.channel);
+        m_members.push_back(std::move(member));
+    }
+
+    qDebug() << "gRPC channel pool created with" << m_members.size() << "channels to"
+             << channel_targets.size() << "targets";
+}
+
+std::vector<std::string> ChannelPool::targets() const {
+    if (m_options.endpoints.size() == 1) {
+        return m_options.endpoints;
+    }
+
+    // Address literals form a single target, the LB policy then balances across them
+    if (std::ranges::all_of(m_options.endpoints, isIpv4Literal)) {
+        return {"ipv4:" + join(m_options.endpoints)};
+    }
+    if (std::ranges::all_of(m_options.endpoints, isIpv6Literal)) {
+        return {"ipv6:" + join(m_options.endpoints)};
+    }
+
+    // Host names resolve separately, one target each; channels are spread over
+    // them whatever the policy, which then applies to each name's addresses
+    return m_options.endpoints;
+}
+
+grpc::GenericStub& ChannelPool::next() {
+    auto index = m_next.fetch_add(1, std::memory_order_relaxed) % m_members.size();
+    return *m_members[index].stub;
+}
+
+std::vector<std::string> ChannelPool::splitEndpoints(std::string_view list) {
+    std::vector<std::string> endpoints;
+    while (!list.empty()) {
+        auto comma = list.find(',');
+        auto endpoint = trim(list.substr(0, comma));
+        if (!endpoint.empty()) {
+            endpoints.emplace_back(endpoint);
+        }
+        if (comma == std::string_view::npos) {
+            break;
+        }
+        list.remove_prefix(comma + 1);
+    }
+    return endpoints;
+}
+
+} // namespace flowdriver
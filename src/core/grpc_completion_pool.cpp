@@ -0,0 +1,54 @@
+#include "core/grpc_completion_pool.hpp"
+#include <algorithm>
+#include <QDebug>
+
+namespace flowdriver {
+
+CompletionQueuePool::CompletionQueuePool()
+    : CompletionQueuePool(std::max(1u, std::thread::hardware_concurrency() / 2))
+{
+}
+
+CompletionQueuePool::CompletionQueuePool(std::size_t threads) {
+    threads = std::max<std::size_t>(1, threads);
+    for (std::size_t i = 0; i < threads; ++i) {
+        m_queues.push_back(std::make_unique<grpc::CompletionQueue>());
+    }
+    for (auto& queue : m_queues) {
+        m_threads.emplace_back([this, cq = queue.get()]() { poll(cq); });
+    }
+
+    qDebug() << "gRPC completion queue pool started with" << threads << "threads";
+}
+
+CompletionQueuePool::~CompletionQueuePool() {
+    for (auto& queue : m_queues) {
+        queue->Shutdown();
+    }
+    // Next() keeps returning pending events until the queue is fully drained
+    for (auto& thread : m_threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+CompletionQueuePool& CompletionQueuePool::instance() {
+    static CompletionQueuePool pool;
+    return pool;
+}
+
+grpc::CompletionQueue* CompletionQueuePool::next() {
+    auto index = m_next.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+    return m_queues[index].get();
+}
+
+void CompletionQueuePool::poll(grpc::CompletionQueue* queue) {
+    void* tag = nullptr;
+    bool ok = false;
+    while (queue->Next(&tag, &ok)) {
+        static_cast<Tag*>(tag)->proceed(ok);
+    }
+}
+
+} // namespace flowdriver
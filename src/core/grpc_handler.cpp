@@ -1,13 +1,30 @@
 #include "core/grpc_handler.hpp"
 #include "core/error.hpp"
+#include "core/descriptor_cache.hpp"
+#include "core/grpc_completion_pool.hpp"
+#include "core/grpc_reflection.hpp"
+#include <boost/asio/associated_executor.hpp>
+#include <boost/asio/async_result.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <algorithm>
+#include <charconv>
 #include <chrono>
+#include <climits>
+#include <optional>
 #include <thread>
 #include <grpcpp/create_channel.h>
+#include <grpcpp/support/proto_buffer_reader.h>
+#include <grpcpp/support/proto_buffer_writer.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
 #include <google/protobuf/compiler/importer.h>
 #include <google/protobuf/dynamic_message.h>
 #include <google/protobuf/util/json_util.h>
+#include <google/protobuf/util/type_resolver.h>
+#include <google/protobuf/util/type_resolver_util.h>
 #include <QDebug>
 #include <filesystem>
+#include <fstream>
 #include <nlohmann/json.hpp>
 
 namespace flowdriver {
@@ -18,54 +35,195 @@ void GrpcHandler::ErrorCollector::AddError(const std::string& filename, int line
     qDebug() << "Proto Error:" << QString::fromStdString(filename) << "line" << line << "column" << column << QString::fromStdString(message);
 }
 
+/**
+ * @brief Descriptor pool built from a FileDescriptorSet
+ */
+struct GrpcHandler::DescriptorSource {
+    google::protobuf::SimpleDescriptorDatabase database;
+    google::protobuf::DescriptorPool pool{&database};
+    // Prototypes are cached by descriptor address, so they live and die with this pool;
+    // declared after it to be destroyed first
+    mutable google::protobuf::DynamicMessageFactory factory;
+};
+
 GrpcHandler::GrpcHandler(QObject* parent) 
     : ProtocolHandler(parent)
-    , m_source_tree(std::make_unique<google::protobuf::compiler::DiskSourceTree>())
-    , m_error_collector(std::make_unique<ErrorCollector>())
-    , m_message_factory(std::make_unique<google::protobuf::DynamicMessageFactory>())
 {
-    m_importer = std::make_unique<google::protobuf::compiler::Importer>(m_source_tree.get(), m_error_collector.get());
 }
 
-GrpcHandler::~GrpcHandler() = default;
+GrpcHandler::~GrpcHandler() {
+    // Completions reference the handler, wait until every call has finished
+    cancel();
+    std::unique_lock<std::mutex> lock(m_callsMutex);
+    m_callsDrained.wait(lock, [this]() { return m_calls.empty(); });
+}
 
 void GrpcHandler::loadProtoFile(const std::string& path) {
     try {
-        std::filesystem::path proto_path(path);
-        auto proto_dir = proto_path.parent_path().string();
-        auto proto_file = proto_path.filename().string();
-        
-        // Reset and reconfigure source tree
-        m_source_tree = std::make_unique<google::protobuf::compiler::DiskSourceTree>();
-        m_source_tree->MapPath("", proto_dir);
-        
-        m_importer = std::make_unique<google::protobuf::compiler::Importer>(m_source_tree.get(), m_error_collector.get());
-        
-        m_current_file = m_importer->Import(proto_file);
-        if (!m_current_file) {
-            throw Error(ErrorCode::INVALID_ARGUMENT, "Failed to import proto file");
-        }
-
-        qDebug() << "Loaded proto file:" << QString::fromStdString(proto_file);
-        qDebug() << "Package name:" << QString::fromStdString(m_current_file->package());
-        qDebug() << "Number of services:" << m_current_file->service_count();
-        
-        for (int i = 0; i < m_current_file->service_count(); i++) {
-            auto service = m_current_file->service(i);
-            qDebug() << "Service" << i << ":"
-                     << "name=" << QString::fromStdString(service->name())
-                     << "full_name=" << QString::fromStdString(service->full_name());
+        std::filesystem::path file_path(path);
+        auto extension = file_path.extension().string();
+        google::protobuf::FileDescriptorSet descriptors;
+        std::vector<std::string> roots;
+
+        if (extension == ".pb" || extension == ".desc" || extension == ".protoset") {
+            // Precompiled, e.g. protoc --include_imports --descriptor_set_out
+            std::ifstream in(file_path, std::ios::binary);
+            if (!in || !descriptors.ParseFromIstream(&in)) {
+                throw Error(ErrorCode::INVALID_ARGUMENT, "Failed to read descriptor set");
+            }
+            for (const auto& file : descriptors.file()) {
+                if (file.service_size() > 0) {
+                    roots.push_back(file.name());
+                }
+            }
+        } else {
+            auto source_root = file_path.parent_path();
+            auto proto_file = file_path.filename().string();
+
+            auto& cache = DescriptorCache::instance();
+            if (auto cached = cache.load(file_path, source_root)) {
+                descriptors = std::move(*cached);
+                qDebug() << "Loaded proto file from descriptor cache:" << QString::fromStdString(proto_file);
+            } else {
+                descriptors = compileProtoFile(source_root.string(), proto_file);
+                cache.store(file_path, source_root, descriptors);
+                qDebug() << "Compiled proto file:" << QString::fromStdString(proto_file);
+            }
+            roots.push_back(proto_file);
+        }
+
+        m_reflection.reset();
+        m_discoveredServices.clear();
+        useDescriptors(descriptors, roots);
+
+        for (const auto* file : m_files) {
+            qDebug() << "File" << QString::fromStdString(file->name())
+                     << "package=" << QString::fromStdString(file->package())
+                     << "services=" << file->service_count();
         }
     } catch (const std::exception& e) {
         throw Error(ErrorCode::INVALID_ARGUMENT, "Failed to load proto file: " + std::string(e.what()));
     }
 }
 
+google::protobuf::FileDescriptorSet GrpcHandler::compileProtoFile(const std::string& directory,
+                                                                  const std::string& file) {
+    google::protobuf::compiler::DiskSourceTree source_tree;
+    source_tree.MapPath("", directory);
+    ErrorCollector error_collector;
+    google::protobuf::compiler::Importer importer(&source_tree, &error_collector);
+
+    const auto* root = importer.Import(file);
+    if (!root) {
+        throw Error(ErrorCode::INVALID_ARGUMENT, "Failed to import proto file");
+    }
+
+    // Dependencies first, the order a FileDescriptorSet is expected in
+    google::protobuf::FileDescriptorSet descriptors;
+    std::unordered_set<std::string> seen;
+    std::function<void(const google::protobuf::FileDescriptor*)> collect =
+        [&](const google::protobuf::FileDescriptor* descriptor) {
+            if (!seen.insert(descriptor->name()).second) {
+                return;
+            }
+            for (int i = 0; i < descriptor->dependency_count(); ++i) {
+                collect(descriptor->dependency(i));
+            }
+            auto* proto = descriptors.add_file();
+            descriptor->CopyTo(proto);
+            descriptor->CopyJsonNameTo(proto);
+        };
+    collect(root);
+    return descriptors;
+}
+
+void GrpcHandler::useDescriptors(const google::protobuf::FileDescriptorSet& descriptors,
+                                 const std::vector<std::string>& roots) {
+    auto source = std::make_shared<DescriptorSource>();
+    for (const auto& file : descriptors.file()) {
+        if (!source->database.Add(file)) {
+            throw Error(ErrorCode::INVALID_ARGUMENT, "Conflicting definitions in " + file.name());
+        }
+    }
+
+    std::vector<const google::protobuf::FileDescriptor*> files;
+    for (const auto& name : roots) {
+        const auto* file = source->pool.FindFileByName(name);
+        if (!file) {
+            throw Error(ErrorCode::INVALID_ARGUMENT, "Failed to build descriptors for " + name);
+        }
+        files.push_back(file);
+    }
+
+    // Calls in flight keep the previous descriptors alive through their plan
+    m_descriptors = std::move(source);
+    m_files = std::move(files);
+    m_current_service = nullptr;
+    m_current_method = nullptr;
+    rebuildPlan();
+}
+
+const google::protobuf::ServiceDescriptor* GrpcHandler::findService(const std::string& service) const {
+    // Accepts the full name as well as the name without its package
+    for (const auto* file : m_files) {
+        for (int i = 0; i < file->service_count(); i++) {
+            const auto* candidate = file->service(i);
+            if (candidate->full_name() == service || candidate->name() == service) {
+                return candidate;
+            }
+        }
+    }
+    return nullptr;
+}
+
+QStringList GrpcHandler::discoverServices() {
+    return adoptDiscovery(prepareDiscovery()());
+}
+
+GrpcHandler::DiscoveryTask GrpcHandler::prepareDiscovery() {
+    return [pool = channels(), endpoint = m_endpoint]() {
+        Discovery discovery;
+        discovery.channels = pool;
+        discovery.reflection = std::make_unique<ReflectionClient>(pool->channel(), endpoint);
+        for (const auto& service : discovery.reflection->listServices()) {
+            // The reflection service itself is not worth offering
+            if (!service.starts_with("grpc.reflection.")) {
+                discovery.services.append(QString::fromStdString(service));
+            }
+        }
+        if (!discovery.services.isEmpty()) {
+            discovery.first = discovery.reflection->fetchService(discovery.services.front().toStdString());
+        }
+        return discovery;
+    };
+}
+
+QStringList GrpcHandler::adoptDiscovery(Discovery discovery) {
+    {
+        std::lock_guard<std::mutex> lock(m_channelMutex);
+        if (m_channels != discovery.channels) {
+            throw Error(ErrorCode::INVALID_STATE, "Endpoint changed while discovering services");
+        }
+    }
+
+    if (discovery.first) {
+        useDescriptors(discovery.first->descriptors, {discovery.first->file});
+    }
+    m_reflection = std::move(discovery.reflection);
+    m_discoveredServices = discovery.services;
+    qDebug() << "Discovered services on" << QString::fromStdString(m_endpoint) << ":" << m_discoveredServices;
+    return m_discoveredServices;
+}
+
 QStringList GrpcHandler::getAvailableServices() const {
+    if (m_reflection) {
+        return m_discoveredServices;
+    }
+
     QStringList services;
-    if (m_current_file) {
-        for (int i = 0; i < m_current_file->service_count(); i++) {
-            services.append(QString::fromStdString(m_current_file->service(i)->full_name()));
+    for (const auto* file : m_files) {
+        for (int i = 0; i < file->service_count(); i++) {
+            services.append(QString::fromStdString(file->service(i)->full_name()));
         }
     }
     qDebug() << "Available services:" << services;
@@ -74,74 +232,31 @@ QStringList GrpcHandler::getAvailableServices() const {
 
 QStringList GrpcHandler::getServiceMethods(const std::string& service) const {
     QStringList methods;
-    if (!m_current_file) {
-        return methods;
-    }
-    
-    qDebug() << "Looking for service methods:" << QString::fromStdString(service);
-    
-    // First try the service name as-is
-    const google::protobuf::ServiceDescriptor* service_desc = m_current_file->FindServiceByName(service);
-    
+    const auto* service_desc = findService(service);
     if (!service_desc) {
-        // If service contains dot, try without package name
-        size_t dot_pos = service.find('.');
-        if (dot_pos != std::string::npos) {
-            std::string service_name = service.substr(dot_pos + 1);
-            qDebug() << "Trying without package name:" << QString::fromStdString(service_name);
-            service_desc = m_current_file->FindServiceByName(service_name);
-        } else {
-            // If no dot and no service found, try with package name
-            std::string package = m_current_file->package();
-            if (!package.empty()) {
-                std::string full_name = package + "." + service;
-                qDebug() << "Trying with package name:" << QString::fromStdString(full_name);
-                service_desc = m_current_file->FindServiceByName(full_name);
-            }
-        }
-    }
-    
-    if (service_desc) {
-        qDebug() << "Found service descriptor with" << service_desc->method_count() << "methods";
-        for (int i = 0; i < service_desc->method_count(); i++) {
-            auto method = service_desc->method(i);
-            qDebug() << "Adding method:" << QString::fromStdString(method->name());
-            methods.append(QString::fromStdString(method->name()));
-        }
-    } else {
         qDebug() << "Service descriptor not found for:" << QString::fromStdString(service);
+        return methods;
+    }
+
+    for (int i = 0; i < service_desc->method_count(); i++) {
+        methods.append(QString::fromStdString(service_desc->method(i)->name()));
     }
-    
     qDebug() << "Methods for service" << QString::fromStdString(service) << ":" << methods;
     return methods;
 }
 
 void GrpcHandler::setService(const std::string& service) {
-    if (!m_current_file) {
+    if (m_files.empty() && !m_reflection) {
         throw Error(ErrorCode::INVALID_ARGUMENT, "No proto file loaded");
     }
-    
-    qDebug() << "Looking for service:" << QString::fromStdString(service);
-    
-    // First try the service name as-is
-    m_current_service = m_current_file->FindServiceByName(service);
-    
-    if (!m_current_service) {
-        // If service contains dot, try without package name
-        size_t dot_pos = service.find('.');
-        if (dot_pos != std::string::npos) {
-            std::string service_name = service.substr(dot_pos + 1);
-            m_current_service = m_current_file->FindServiceByName(service_name);
-        } else {
-            // If no dot and no service found, try with package name
-            std::string package = m_current_file->package();
-            if (!package.empty()) {
-                std::string full_name = package + "." + service;
-                m_current_service = m_current_file->FindServiceByName(full_name);
-            }
-        }
+
+    m_current_service = findService(service);
+    if (!m_current_service && m_reflection) {
+        // Descriptors of a discovered service are fetched when it is first selected
+        auto fetched = m_reflection->fetchService(service);
+        useDescriptors(fetched.descriptors, {fetched.file});
+        m_current_service = findService(service);
     }
-    
     if (!m_current_service) {
         throw Error(ErrorCode::INVALID_ARGUMENT, "Service not found: " + service);
     }
@@ -149,6 +264,26 @@ void GrpcHandler::setService(const std::string& service) {
     qDebug() << "Found service with" << m_current_service->method_count() << "methods";
 }
 
+GrpcHandler::ServiceFetchTask GrpcHandler::prepareServiceFetch(const std::string& service) {
+    if (!m_reflection || findService(service)) {
+        return {};
+    }
+    return [reflection = m_reflection, service]() {
+        auto descriptors = reflection->fetchService(service);
+        return ServiceFetch{reflection, service, std::move(descriptors)};
+    };
+}
+
+void GrpcHandler::adoptService(ServiceFetch fetch) {
+    if (m_reflection != fetch.reflection) {
+        throw Error(ErrorCode::INVALID_STATE, "Endpoint changed while fetching service descriptors");
+    }
+    if (!findService(fetch.service)) {
+        useDescriptors(fetch.descriptors.descriptors, {fetch.descriptors.file});
+    }
+    setService(fetch.service);
+}
+
 void GrpcHandler::setMethod(const std::string& method) {
     if (!m_current_service) {
         throw Error(ErrorCode::INVALID_STATE, "No service selected");
@@ -157,157 +292,825 @@ void GrpcHandler::setMethod(const std::string& method) {
     if (!m_current_method) {
         throw Error(ErrorCode::INVALID_CONFIG, "Method not found: " + method);
     }
+    rebuildPlan();
 }
 
 void GrpcHandler::setEndpoint(const std::string& endpoint) {
     m_endpoint = endpoint;
-    createChannel();
+    m_channelOptions.endpoints = ChannelPool::splitEndpoints(endpoint);
+    resetChannels();
 }
 
 void GrpcHandler::setUseSSL(bool use_ssl) {
-    m_useSsl = use_ssl;
-    createChannel();
+    m_channelOptions.use_ssl = use_ssl;
+    resetChannels();
 }
 
-void GrpcHandler::createChannel() {
-    grpc::ChannelArguments args;
-    args.SetInt(GRPC_ARG_MAX_RECEIVE_MESSAGE_LENGTH, -1);
-    args.SetInt(GRPC_ARG_MAX_SEND_MESSAGE_LENGTH, -1);
-    
-    if (m_useSsl) {
-        grpc::SslCredentialsOptions ssl_opts;
-        m_channel = grpc::CreateCustomChannel(m_endpoint, grpc::SslCredentials(ssl_opts), args);
-    } else {
-        m_channel = grpc::CreateCustomChannel(m_endpoint, grpc::InsecureChannelCredentials(), args);
+void GrpcHandler::setChannelOptions(ChannelPool::Options options) {
+    // The endpoint list and TLS keep following setEndpoint() / setUseSSL()
+    options.endpoints = m_channelOptions.endpoints;
+    options.use_ssl = m_channelOptions.use_ssl;
+    m_channelOptions = std::move(options);
+    resetChannels();
+}
+
+void GrpcHandler::resetChannels() {
+    {
+        // Built on first use, so typing an endpoint does not open connections
+        std::lock_guard<std::mutex> lock(m_channelMutex);
+        m_channels.reset();
     }
-    
-    m_generic_stub = std::make_unique<grpc::GenericStub>(m_channel);
+
+    // Discovered services belong to the previous endpoint
+    m_reflection.reset();
+    m_discoveredServices.clear();
 }
 
-RequestResult GrpcHandler::execute(const RequestConfig& config) {
-    RequestResult result;
-    try {
-        if (!m_current_method) {
-            throw Error(ErrorCode::INVALID_ARGUMENT, "No method selected");
+std::shared_ptr<ChannelPool> GrpcHandler::channels() {
+    std::lock_guard<std::mutex> lock(m_channelMutex);
+    if (!m_channels) {
+        m_channels = std::make_shared<ChannelPool>(m_channelOptions);
+    }
+    return m_channels;
+}
+
+namespace {
+    // Messages retained in the body of a streaming result, later ones are only counted
+    constexpr std::size_t kMaxRetainedMessages = 1000;
+
+    constexpr std::size_t kArenaBlockSize = 64 * 1024;
+    constexpr std::size_t kMaxPooledArenaBlocks = 256;
+
+    /**
+     * @brief Recycled initial blocks for per-call protobuf arenas
+     */
+    class ArenaBlockPool {
+    public:
+        std::unique_ptr<char[]> acquire() {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!free_.empty()) {
+                    auto block = std::move(free_.back());
+                    free_.pop_back();
+                    return block;
+                }
+            }
+            return std::make_unique<char[]>(kArenaBlockSize);
         }
-        
-        if (!m_channel || !m_generic_stub) {
-            createChannel();
+
+        void release(std::unique_ptr<char[]> block) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (free_.size() < kMaxPooledArenaBlocks) {
+                free_.push_back(std::move(block));
+            }
         }
-        
-        executeMethod(config, result);
-        return result;
-    } catch (const Error& e) {
-        throw;
-    } catch (const std::exception& e) {
-        throw Error(ErrorCode::INTERNAL_ERROR, std::string("gRPC call failed: ") + e.what());
+
+        static ArenaBlockPool& instance() {
+            static ArenaBlockPool pool;
+            return pool;
+        }
+
+    private:
+        std::mutex mutex_;
+        std::vector<std::unique_ptr<char[]>> free_;
+    };
+
+    /**
+     * @brief Protobuf arena whose first block comes from the pool
+     *
+     * Messages and all their submessages and strings are allocated on the
+     * arena and released together, by reset() or on destruction.
+     */
+    class PooledArena {
+    public:
+        PooledArena()
+            : block_(ArenaBlockPool::instance().acquire())
+        {
+            arena_.emplace(block_.get(), kArenaBlockSize);
+        }
+
+        ~PooledArena() {
+            // Destroy the arena before its initial block goes back to the pool
+            arena_.reset();
+            ArenaBlockPool::instance().release(std::move(block_));
+        }
+
+        PooledArena(const PooledArena&) = delete;
+        PooledArena& operator=(const PooledArena&) = delete;
+
+        google::protobuf::Message* create(const google::protobuf::Message* prototype) {
+            return prototype->New(&*arena_);
+        }
+
+        // Frees everything but the initial block
+        void reset() { arena_->Reset(); }
+
+    private:
+        std::unique_ptr<char[]> block_;
+        std::optional<google::protobuf::Arena> arena_;
+    };
+
+    std::chrono::microseconds elapsedSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start);
     }
-}
 
-void GrpcHandler::executeMethod(const RequestConfig& config, RequestResult& result) {
-    try {
-        grpc::ClientContext context;
-        std::string method_name = "/" + m_current_service->full_name() + "/" + m_current_method->name();
-        
-        qDebug() << "Executing gRPC method:" << QString::fromStdString(method_name);
-        
-        for (const auto& header : m_auth_headers) {
-            context.AddMetadata(header.name, header.value);
-            qDebug() << "Using auth header:" << QString::fromStdString(header.name)
-                     << "=" << QString::fromStdString(header.value);
-        }
-        
-        for (const auto& header : config.headers) {
-            context.AddMetadata(header.name, header.value);
-        }
-        
-        // Create request message
-        auto request = m_message_factory->GetPrototype(m_current_method->input_type())->New();
-        auto response = m_message_factory->GetPrototype(m_current_method->output_type())->New();
-        
-        // Parse request JSON
-        std::string json_request = config.body.empty() ? "{}" : config.body; // Use empty object if no body
-        auto status = google::protobuf::util::JsonStringToMessage(json_request, request);
-        if (!status.ok()) {
-            std::string error_msg = "Failed to parse request JSON: ";
-            error_msg += status.ToString();
-            qDebug() << "JSON parsing error:" << QString::fromStdString(error_msg);
-            throw Error(ErrorCode::INVALID_ARGUMENT, error_msg);
-        }
-        
-        std::string binary_request;
-        if (!request->SerializeToString(&binary_request)) {
-            throw Error(ErrorCode::INVALID_ARGUMENT, "Failed to serialize request");
-        }
-        
-        // Create gRPC byte buffer from serialized request
-        grpc::Slice slice(binary_request);
-        grpc::ByteBuffer request_buffer(&slice, 1);
-        grpc::ByteBuffer response_buffer;
-        
-        // Create completion queue for async operations
-        grpc::CompletionQueue cq;
-        std::unique_ptr<grpc::ClientAsyncResponseReader<grpc::ByteBuffer>> rpc(
-            m_generic_stub->PrepareUnaryCall(&context, method_name, request_buffer, &cq));
-
-        rpc->StartCall();
-        
-        grpc::Status grpc_status;
-        rpc->Finish(&response_buffer, &grpc_status, (void*)1);
-        
-        void* got_tag;
-        bool ok = false;
-        cq.Next(&got_tag, &ok);
-        
-        if (grpc_status.ok()) {
-            std::string binary_response;
-            std::vector<grpc::Slice> slices;
-            response_buffer.Dump(&slices);
-            for (const auto& s : slices) {
-                binary_response.append(reinterpret_cast<const char*>(s.begin()), s.size());
+    constexpr const char* kTypeUrlPrefix = "type.googleapis.com";
+
+    // Above this payload size responses are rendered compactly: pretty printing and
+    // default-valued fields multiply the output of large repeated fields
+    constexpr std::size_t kCompactJsonThreshold = 1024 * 1024;
+
+    std::string flatten(grpc::ByteBuffer& buffer) {
+        std::string bytes;
+        bytes.reserve(buffer.Length());
+        std::vector<grpc::Slice> slices;
+        buffer.Dump(&slices);
+        for (const auto& s : slices) {
+            bytes.append(reinterpret_cast<const char*>(s.begin()), s.size());
+        }
+        return bytes;
+    }
+
+    // RequestConfig::timeout bounds the whole call, streams included; 0 leaves it unbounded
+    void setDeadline(grpc::ClientContext& context, const RequestConfig& config) {
+        if (config.timeout.count() > 0) {
+            context.set_deadline(std::chrono::system_clock::now() + config.timeout);
+        }
+    }
+
+    Error deadlineError() {
+        return Error(ErrorCode::TIMEOUT, "gRPC call exceeded its deadline");
+    }
+
+    // Shortest text that reads back as the same value, 1.5 rather than 1.500000
+    template <typename T>
+    std::string floatText(T value) {
+        char text[32];
+        auto result = std::to_chars(text, text + sizeof(text), value);
+        return std::string(text, result.ptr);
+    }
+
+    // Text form of a singular scalar field addressed by a dotted path, e.g. "status.code"
+    std::optional<std::string> fieldText(const google::protobuf::Message& root, std::string_view path) {
+        using google::protobuf::FieldDescriptor;
+
+        const google::protobuf::Message* message = &root;
+        while (true) {
+            auto dot = path.find('.');
+            auto name = std::string(path.substr(0, dot));
+            const auto* field = message->GetDescriptor()->FindFieldByName(name);
+            if (!field || field->is_repeated()) {
+                return std::nullopt;
             }
-            
-            if (!response->ParseFromString(binary_response)) {
-                throw Error(ErrorCode::INVALID_ARGUMENT, "Failed to parse response");
+
+            const auto* reflection = message->GetReflection();
+            if (dot != std::string_view::npos) {
+                if (field->cpp_type() != FieldDescriptor::CPPTYPE_MESSAGE) {
+                    return std::nullopt;
+                }
+                message = &reflection->GetMessage(*message, field);
+                path.remove_prefix(dot + 1);
+                continue;
             }
-            
-            google::protobuf::util::JsonPrintOptions options;
-            options.add_whitespace = true;
-            options.always_print_primitive_fields = true;
-            
-            std::string response_json;
-            status = google::protobuf::util::MessageToJsonString(*response, &response_json, options);
+
+            switch (field->cpp_type()) {
+            case FieldDescriptor::CPPTYPE_INT32: return std::to_string(reflection->GetInt32(*message, field));
+            case FieldDescriptor::CPPTYPE_INT64: return std::to_string(reflection->GetInt64(*message, field));
+            case FieldDescriptor::CPPTYPE_UINT32: return std::to_string(reflection->GetUInt32(*message, field));
+            case FieldDescriptor::CPPTYPE_UINT64: return std::to_string(reflection->GetUInt64(*message, field));
+            case FieldDescriptor::CPPTYPE_DOUBLE: return floatText(reflection->GetDouble(*message, field));
+            case FieldDescriptor::CPPTYPE_FLOAT: return floatText(reflection->GetFloat(*message, field));
+            case FieldDescriptor::CPPTYPE_BOOL: return reflection->GetBool(*message, field) ? "true" : "false";
+            case FieldDescriptor::CPPTYPE_ENUM: return reflection->GetEnum(*message, field)->name();
+            case FieldDescriptor::CPPTYPE_STRING: return reflection->GetString(*message, field);
+            default: return std::nullopt;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Everything a call needs about the selected method, resolved once
+ */
+struct GrpcHandler::CallPlan {
+    CallPlan(const google::protobuf::MethodDescriptor* method, std::shared_ptr<const DescriptorSource> owner)
+        : path("/" + method->service()->full_name() + "/" + method->name())
+        , client_streaming(method->client_streaming())
+        , server_streaming(method->server_streaming())
+        , request_prototype(owner->factory.GetPrototype(method->input_type()))
+        , response_prototype(owner->factory.GetPrototype(method->output_type()))
+        , request_type(std::string(kTypeUrlPrefix) + "/" + method->input_type()->full_name())
+        , response_type(std::string(kTypeUrlPrefix) + "/" + method->output_type()->full_name())
+        , resolver(google::protobuf::util::NewTypeResolverForDescriptorPool(kTypeUrlPrefix, method->file()->pool()))
+        , descriptors(std::move(owner))
+    {
+    }
+
+    /**
+     * @brief Convert a JSON document straight to wire format
+     *
+     * Streams between JSON and the wire format using the type resolver, no
+     * message is built on the way, and writes into the slices of the
+     * outgoing buffer.
+     */
+    Expected<grpc::ByteBuffer> encode(const std::string& document) const {
+        google::protobuf::io::ArrayInputStream input(document.data(), static_cast<int>(document.size()));
+
+        // The wire form is rarely larger than its JSON, so one slice usually holds it;
+        // the final size is unknown up front and only bounds the writer
+        auto block = std::clamp(static_cast<int>(std::min<std::size_t>(document.size(), INT_MAX)), 64,
+                                grpc::kProtoBufferWriterMaxBufferLength);
+        grpc::ByteBuffer buffer;
+        {
+            grpc::ProtoBufferWriter output(&buffer, block, INT_MAX);
+            auto status = google::protobuf::util::JsonToBinaryStream(resolver.get(), request_type, &input, &output);
             if (!status.ok()) {
-                throw Error(ErrorCode::INVALID_ARGUMENT, "Failed to convert response to JSON");
+                return makeError(ErrorCode::INVALID_ARGUMENT, "Failed to parse request JSON: " + status.ToString());
             }
-            
-            result.body = response_json;
+        }
+        return buffer;
+    }
+
+    /**
+     * @brief Render a serialized response message as JSON in one pass
+     * @param input Wire format of the message
+     * @param bytes Size of the message, selects the compact form for large payloads
+     */
+    Expected<std::string> render(google::protobuf::io::ZeroCopyInputStream& input, std::size_t bytes) const {
+        google::protobuf::util::JsonPrintOptions options;
+        options.add_whitespace = bytes < kCompactJsonThreshold;
+        options.always_print_primitive_fields = bytes < kCompactJsonThreshold;
+
+        std::string json;
+        json.reserve(bytes * 2);
+        {
+            google::protobuf::io::StringOutputStream output(&json);
+            auto status = google::protobuf::util::BinaryToJsonStream(resolver.get(), response_type, &input, &output, options);
+            if (!status.ok()) {
+                return makeError(ErrorCode::INVALID_ARGUMENT, "Failed to convert response to JSON: " + status.ToString());
+            }
+        }
+        return json;
+    }
+
+    /**
+     * @brief Decode one received message according to the payload mode
+     * @param buffer Received message
+     * @param bytes Set to the payload size
+     * @param arena Arena for the parsed message, only created when assertions need one
+     * @return JSON in JSON mode, the protobuf bytes in BINARY mode after checking the assertions
+     */
+    Expected<std::string> decode(grpc::ByteBuffer& buffer, std::size_t& bytes,
+                                 std::optional<PooledArena>& arena) const {
+        bytes = buffer.Length();
+
+        // Reads the slices in place, no contiguous copy of the payload
+        grpc::ProtoBufferReader reader(&buffer);
+        if (!reader.status().ok()) {
+            return makeError(ErrorCode::INVALID_ARGUMENT, "Failed to read response");
+        }
+        if (payload_mode == PayloadMode::JSON) {
+            return render(reader, bytes);
+        }
+        if (assertions.empty()) {
+            return flatten(buffer);
+        }
+
+        if (!arena) {
+            arena.emplace();
+        }
+        auto* message = arena->create(response_prototype);
+        if (!message->ParseFromZeroCopyStream(&reader)) {
+            return makeError(ErrorCode::INVALID_ARGUMENT, "Failed to parse response");
+        }
+
+        for (const auto& assertion : assertions) {
+            auto actual = fieldText(*message, assertion.path);
+            if (!actual || *actual != assertion.expected) {
+                return makeError(ErrorCode::PROTOCOL_ERROR,
+                                 "Assertion failed: " + assertion.path + " is '" +
+                                 actual.value_or("<missing>") + "', expected '" + assertion.expected + "'");
+            }
+        }
+
+        return flatten(buffer);
+    }
+
+    /**
+     * @brief Encoded request for a JSON body, converted only on first use in BINARY mode
+     */
+    Expected<std::vector<grpc::ByteBuffer>> requests(const std::string& body) const {
+        if (payload_mode != PayloadMode::BINARY) {
+            return encodeRequests(*this, body);
+        }
+
+        std::lock_guard<std::mutex> lock(encoded_mutex);
+        auto it = encoded.find(body);
+        if (it != encoded.end()) {
+            return it->second;  // ByteBuffer copies share the slices
+        }
+
+        auto buffers = encodeRequests(*this, body);
+        if (buffers) {
+            if (encoded.size() >= kMaxEncodedRequests) {
+                encoded.clear();
+            }
+            encoded.emplace(body, *buffers);
+        }
+        return buffers;
+    }
+
+    std::string path;               // "/package.Service/Method"
+    bool client_streaming;
+    bool server_streaming;
+    std::vector<Header> metadata;   // Auth headers sent with every call
+    const google::protobuf::Message* request_prototype;
+    const google::protobuf::Message* response_prototype;
+    std::string request_type;       // Type URLs understood by the resolver
+    std::string response_type;
+    std::unique_ptr<google::protobuf::util::TypeResolver> resolver;
+    PayloadMode payload_mode{PayloadMode::JSON};
+    std::vector<FieldAssertion> assertions;
+    std::shared_ptr<const DescriptorSource> descriptors;  // Keeps the descriptors and prototypes alive
+
+private:
+    static constexpr std::size_t kMaxEncodedRequests = 64;
+
+    mutable std::mutex encoded_mutex;
+    mutable std::unordered_map<std::string, std::vector<grpc::ByteBuffer>> encoded;
+};
+
+void GrpcHandler::rebuildPlan() {
+    std::shared_ptr<const CallPlan> plan;
+    if (m_current_method) {
+        auto built = std::make_shared<CallPlan>(m_current_method, m_descriptors);
+        built->metadata = m_auth_headers;
+        built->payload_mode = m_payloadMode;
+        built->assertions = m_assertions;
+        plan = std::move(built);
+    }
+
+    std::lock_guard<std::mutex> lock(m_planMutex);
+    m_plan = std::move(plan);
+}
+
+std::shared_ptr<const GrpcHandler::CallPlan> GrpcHandler::currentPlan() const {
+    std::lock_guard<std::mutex> lock(m_planMutex);
+    return m_plan;
+}
+
+/**
+ * @brief State shared by every in-flight call
+ */
+class GrpcHandler::Call {
+public:
+    Call(GrpcHandler* handler, std::shared_ptr<const CallPlan> plan, CallCallback callback)
+        : handler_(handler)
+        , plan_(std::move(plan))
+        , callback_(std::move(callback))
+    {
+    }
+
+    virtual ~Call() = default;
+
+    void complete(Expected<RequestResult> result) {
+        callback_(std::move(result));
+    }
+
+    grpc::ClientContext context;
+
+protected:
+    // Deliver the result and release the call, nothing may touch it afterwards
+    void finish(Expected<RequestResult> result) {
+        complete(std::move(result));
+        std::unique_ptr<Call> self(this);
+        handler_->finishCall(this);
+    }
+
+    GrpcHandler* handler_;
+    std::shared_ptr<const CallPlan> plan_;
+    std::chrono::steady_clock::time_point started_{std::chrono::steady_clock::now()};
+
+private:
+    CallCallback callback_;
+};
+
+/**
+ * @brief In-flight unary call, completed on a CompletionQueuePool thread
+ */
+class GrpcHandler::UnaryCall final : public Call, public CompletionQueuePool::Tag {
+public:
+    using Call::Call;
+
+    void proceed(bool ok) override {
+        finish(ok ? decode() : makeError(ErrorCode::NETWORK_ERROR, "gRPC call was not completed"));
+    }
+
+    grpc::ByteBuffer response;
+    grpc::Status status;
+    std::unique_ptr<grpc::ClientAsyncResponseReader<grpc::ByteBuffer>> reader;
+
+private:
+    Expected<RequestResult> decode() {
+        std::optional<PooledArena> arena;
+        RequestResult result;
+        result.metrics.total_time = elapsedSince(started_);
+        if (status.error_code() == grpc::StatusCode::DEADLINE_EXCEEDED) {
+            return std::unexpected(deadlineError());
+        }
+        if (!status.ok()) {
+            result.error = status.error_message();
+            result.status_code = static_cast<int>(status.error_code());
+            return result;
+        }
+
+        auto body = plan_->decode(response, result.metrics.bytes_received, arena);
+        if (!body) {
+            return std::unexpected(std::move(body.error()));
+        }
+        result.body = std::move(*body);
+        result.status_code = 200;
+        return result;
+    }
+};
+
+/**
+ * @brief Streaming call driven by completion queue events
+ *
+ * Keeps at most one read and one write outstanding, so a slow peer applies
+ * backpressure through gRPC flow control instead of unbounded buffering.
+ * All events of a call arrive on the same queue thread and never overlap.
+ */
+class GrpcHandler::StreamCall final : public Call {
+public:
+    StreamCall(GrpcHandler* handler, std::shared_ptr<const CallPlan> plan,
+               std::vector<grpc::ByteBuffer> requests, CallCallback callback)
+        : Call(handler, std::move(plan), std::move(callback))
+        , requests_(std::move(requests))
+        , last_message_(started_)
+    {
+    }
+
+    void start(grpc::GenericStub& stub, const std::string& method, grpc::CompletionQueue* cq) {
+        stream_ = stub.PrepareCall(&context, method, cq);
+        stream_->StartCall(&start_op_);
+    }
+
+private:
+    // One tag per kind of operation, none of them is ever outstanding twice
+    class Op final : public CompletionQueuePool::Tag {
+    public:
+        Op(StreamCall* call, void (StreamCall::*event)(bool)) : call_(call), event_(event) {}
+        void proceed(bool ok) override { (call_->*event_)(ok); }
+
+    private:
+        StreamCall* call_;
+        void (StreamCall::*event_)(bool);
+    };
+
+    void onStarted(bool ok) {
+        if (!ok) {
+            // The call never started, Finish() reports why
+            maybeFinish();
+            return;
+        }
+        writeNext();
+        reading_ = true;
+        stream_->Read(&incoming_, &read_op_);
+    }
+
+    void writeNext() {
+        if (next_request_ < requests_.size()) {
+            writing_ = true;
+            stream_->Write(requests_[next_request_], &write_op_);
+        } else if (!writes_closed_) {
+            writes_closed_ = true;
+            writing_ = true;
+            stream_->WritesDone(&write_op_);
+        }
+    }
+
+    void onWritten(bool ok) {
+        writing_ = false;
+        if (!writes_closed_) {
+            if (ok) {
+                ++metrics_.messages_sent;
+                metrics_.bytes_sent += requests_[next_request_].Length();
+                ++next_request_;
+                writeNext();
+            } else {
+                // The stream is broken, the status comes from Finish()
+                writes_closed_ = true;
+            }
+        }
+        maybeFinish();
+    }
+
+    void onRead(bool ok) {
+        if (!ok) {
+            reading_ = false;
+            maybeFinish();
+            return;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        auto gap = std::chrono::duration_cast<std::chrono::microseconds>(now - last_message_);
+        last_message_ = now;
+        if (metrics_.messages_received == 0) {
+            metrics_.first_message_time = gap;
+        }
+        metrics_.max_message_gap = std::max(metrics_.max_message_gap, gap);
+
+        std::size_t bytes = 0;
+        auto body = plan_->decode(incoming_, bytes, arena_);
+        if (arena_) {
+            arena_->reset();  // Only the current message lives on the arena
+        }
+        metrics_.bytes_received += bytes;
+        if (body) {
+            handler_->deliverStreamMessage(*plan_, {metrics_.messages_received, *body, gap});
+            if (messages_.size() < kMaxRetainedMessages) {
+                messages_.push_back(std::move(*body));
+            }
+        } else if (!decode_error_) {
+            decode_error_ = std::move(body.error());
+        }
+        ++metrics_.messages_received;
+
+        incoming_.Clear();
+        stream_->Read(&incoming_, &read_op_);
+    }
+
+    void maybeFinish() {
+        if (reading_ || writing_ || finishing_) {
+            return;
+        }
+        finishing_ = true;
+        stream_->Finish(&status_, &finish_op_);
+    }
+
+    void onFinished(bool) {
+        RequestResult result;
+        result.metrics = metrics_;
+        result.metrics.total_time = elapsedSince(started_);
+        if (result.metrics.total_time.count() > 0) {
+            result.metrics.messages_per_second = static_cast<double>(metrics_.messages_received) * 1e6 /
+                                                 static_cast<double>(result.metrics.total_time.count());
+        }
+
+        if (status_.error_code() == grpc::StatusCode::DEADLINE_EXCEEDED) {
+            finish(std::unexpected(deadlineError()));
+            return;
+        }
+        if (!status_.ok()) {
+            result.error = status_.error_message();
+            result.status_code = static_cast<int>(status_.error_code());
+        } else if (decode_error_) {
+            finish(std::unexpected(std::move(*decode_error_)));
+            return;
+        } else {
             result.status_code = 200;
+            result.body = plan_->server_streaming ? joinMessages()
+                                            : (messages_.empty() ? std::string("{}") : messages_.front());
+        }
+        finish(std::move(result));
+    }
+
+    std::string joinMessages() const {
+        std::string body = "[";
+        for (std::size_t i = 0; i < messages_.size(); ++i) {
+            body += i == 0 ? "\n" : ",\n";
+            body += messages_[i];
+        }
+        body += "\n]";
+        return body;
+    }
+
+    std::vector<grpc::ByteBuffer> requests_;
+    std::size_t next_request_{0};
+    std::optional<PooledArena> arena_;  // Created by the first message that is parsed
+    std::unique_ptr<grpc::GenericClientAsyncReaderWriter> stream_;
+    grpc::ByteBuffer incoming_;
+    grpc::Status status_;
+
+    Op start_op_{this, &StreamCall::onStarted};
+    Op read_op_{this, &StreamCall::onRead};
+    Op write_op_{this, &StreamCall::onWritten};
+    Op finish_op_{this, &StreamCall::onFinished};
+
+    bool reading_{false};
+    bool writing_{false};
+    bool writes_closed_{false};
+    bool finishing_{false};
+
+    RequestMetrics metrics_;
+    std::chrono::steady_clock::time_point last_message_;
+    std::vector<std::string> messages_;
+    std::optional<Error> decode_error_;
+};
+
+RequestResult GrpcHandler::execute(const RequestConfig& config) {
+    return valueOrThrow(tryExecute(config));
+}
+
+Expected<RequestResult> GrpcHandler::tryExecute(const RequestConfig& config) noexcept {
+    try {
+        // Blocks only the caller, the call itself is driven by the shared completion queues
+        std::promise<Expected<RequestResult>> promise;
+        auto future = promise.get_future();
+        startCall(config, [&promise](Expected<RequestResult> result) {
+            promise.set_value(std::move(result));
+        });
+        return future.get();
+    } catch (const std::exception& e) {
+        return makeError(ErrorCode::INTERNAL_ERROR, std::string("gRPC call failed: ") + e.what());
+    }
+}
+
+std::future<RequestResult> GrpcHandler::executeAsync(const RequestConfig& config) {
+    auto promise = std::make_shared<std::promise<RequestResult>>();
+    auto future = promise->get_future();
+    startCall(config, [promise](Expected<RequestResult> result) {
+        if (result) {
+            promise->set_value(std::move(*result));
         } else {
-            result.error = grpc_status.error_message();
-            result.status_code = static_cast<int>(grpc_status.error_code());
+            promise->set_exception(std::make_exception_ptr(std::move(result.error())));
         }
-        
-        delete request;
-        delete response;
+    });
+    return future;
+}
+
+boost::asio::awaitable<RequestResult> GrpcHandler::co_execute(const RequestConfig& config) {
+    return awaitCall(config);
+}
+
+boost::asio::awaitable<RequestResult> GrpcHandler::awaitCall(RequestConfig config) {
+    namespace net = boost::asio;
+
+    co_return co_await net::async_initiate<const net::use_awaitable_t<>&,
+                                           void(std::exception_ptr, RequestResult)>(
+        [this, &config](auto handler) {
+            auto work = net::get_associated_executor(handler);
+            startCall(config, [work, handler = std::move(handler)](Expected<RequestResult> result) mutable {
+                // Resume the awaiting coroutine on its own executor, not on the queue thread
+                net::post(work, [handler = std::move(handler), result = std::move(result)]() mutable {
+                    if (result) {
+                        std::move(handler)(nullptr, std::move(*result));
+                    } else {
+                        std::move(handler)(std::make_exception_ptr(std::move(result.error())), RequestResult{});
+                    }
+                });
+            });
+        },
+        net::use_awaitable);
+}
+
+void GrpcHandler::startCall(const RequestConfig& config, CallCallback callback) {
+    auto plan = currentPlan();
+    if (!plan) {
+        callback(makeError(ErrorCode::INVALID_ARGUMENT, "No method selected"));
+        return;
+    }
+
+    auto requests = plan->requests(config.body);
+    if (!requests) {
+        callback(std::unexpected(std::move(requests.error())));
+        return;
+    }
+
+    std::shared_ptr<ChannelPool> pool;
+    try {
+        pool = channels();
     } catch (const Error& e) {
-        qDebug() << "GrpcHandler error:" << QString::fromStdString(e.what());
-        throw;
-    } catch (const std::exception& e) {
-        qDebug() << "Unexpected error in GrpcHandler:" << e.what();
-        throw Error(ErrorCode::INTERNAL_ERROR, std::string("gRPC execution failed: ") + e.what());
+        callback(std::unexpected(e));
+        return;
+    }
+    auto& stub = pool->next();
+
+    auto* cq = CompletionQueuePool::instance().next();
+
+    if (plan->client_streaming || plan->server_streaming) {
+        auto call = std::make_unique<StreamCall>(this, plan, std::move(*requests), std::move(callback));
+        addMetadata(call->context, *plan, config);
+        setDeadline(call->context, config);
+        trackCall(call.get());
+
+        // Ownership passes to the completion queue until the stream finishes
+        call.release()->start(stub, plan->path, cq);
+        return;
+    }
+
+    auto call = std::make_unique<UnaryCall>(this, plan, std::move(callback));
+    addMetadata(call->context, *plan, config);
+    setDeadline(call->context, config);
+
+    call->reader = stub.PrepareUnaryCall(&call->context, plan->path, requests->front(), cq);
+    trackCall(call.get());
+    call->reader->StartCall();
+
+    // Ownership passes to the completion queue until proceed() runs
+    auto* tag = call.release();
+    tag->reader->Finish(&tag->response, &tag->status, static_cast<CompletionQueuePool::Tag*>(tag));
+}
+
+void GrpcHandler::addMetadata(grpc::ClientContext& context, const CallPlan& plan, const RequestConfig& config) {
+    for (const auto& header : plan.metadata) {
+        context.AddMetadata(header.name, header.value);
+    }
+    for (const auto& header : config.headers) {
+        context.AddMetadata(header.name, header.value);
     }
 }
 
+Expected<std::vector<grpc::ByteBuffer>> GrpcHandler::encodeRequests(const CallPlan& plan, const std::string& body) {
+    // A client-streaming method takes a JSON array, one element per message
+    std::vector<std::string> documents;
+    if (plan.client_streaming) {
+        try {
+            auto parsed = json::parse(body.empty() ? "[]" : body);
+            if (parsed.is_array()) {
+                for (const auto& element : parsed) {
+                    documents.push_back(element.dump());
+                }
+            } else {
+                documents.push_back(parsed.dump());
+            }
+        } catch (const json::parse_error& e) {
+            return makeError(ErrorCode::PARSE_ERROR, "Failed to parse JSON request: " + std::string(e.what()));
+        }
+    } else {
+        documents.push_back(body.empty() ? "{}" : body); // Use empty object if no body
+    }
+
+    std::vector<grpc::ByteBuffer> buffers;
+    buffers.reserve(documents.size());
+    for (const auto& document : documents) {
+        auto buffer = plan.encode(document);
+        if (!buffer) {
+            qDebug() << "JSON parsing error:" << QString::fromStdString(buffer.error().what());
+            return std::unexpected(std::move(buffer.error()));
+        }
+        buffers.push_back(std::move(*buffer));
+    }
+    return buffers;
+}
+
+void GrpcHandler::deliverStreamMessage(const CallPlan& plan, const StreamMessage& message) {
+    if (m_streamMessageHandler) {
+        m_streamMessageHandler(message);
+    }
+    // Binary bodies are not for display, renderJson() converts them on demand
+    if (plan.payload_mode == PayloadMode::JSON) {
+        emit streamMessageReceived(QString::fromStdString(message.body));
+    }
+}
+
+void GrpcHandler::setPayloadMode(PayloadMode mode) {
+    m_payloadMode = mode;
+    rebuildPlan();
+}
+
+void GrpcHandler::setResponseAssertions(std::vector<FieldAssertion> assertions) {
+    m_assertions = std::move(assertions);
+    rebuildPlan();
+}
+
+Expected<std::string> GrpcHandler::renderJson(const std::string& binary) const {
+    auto plan = currentPlan();
+    if (!plan) {
+        return makeError(ErrorCode::INVALID_STATE, "No method selected");
+    }
+
+    google::protobuf::io::ArrayInputStream input(binary.data(), static_cast<int>(binary.size()));
+    return plan->render(input, binary.size());
+}
+
+void GrpcHandler::setStreamMessageHandler(StreamMessageCallback callback) {
+    m_streamMessageHandler = std::move(callback);
+}
+
+void GrpcHandler::trackCall(Call* call) {
+    std::lock_guard<std::mutex> lock(m_callsMutex);
+    m_calls.insert(call);
+}
+
+void GrpcHandler::finishCall(Call* call) {
+    {
+        std::lock_guard<std::mutex> lock(m_callsMutex);
+        m_calls.erase(call);
+    }
+    m_callsDrained.notify_all();
+}
+
 void GrpcHandler::cancel() {
-    // Cancel any ongoing gRPC calls by creating a new channel
-    // This effectively interrupts any in-progress calls
+    // Cancel every call still in flight, each completes with CANCELLED
     qDebug() << "Cancelling gRPC requests";
-    
-    m_channel.reset();
-    m_generic_stub.reset();
-    
-    createChannel();
+
+    std::lock_guard<std::mutex> lock(m_callsMutex);
+    for (auto* call : m_calls) {
+        call->context.TryCancel();
+    }
 }
 
 void GrpcHandler::setAuthMetadata(const QVariantList& headers) {
@@ -326,49 +1129,9 @@ void GrpcHandler::setAuthMetadata(const QVariantList& headers) {
                      << "=" << QString::fromStdString(value);
         }
     }
-}
-
-std::future<RequestResult> GrpcHandler::executeAsync(const RequestConfig& config) {
-    return std::async(std::launch::async, [this, config]() {
-        return execute(config);
-    });
-}
 
-std::string GrpcHandler::serializeRequest(const std::string& json_request) {
-    try {
-        auto json_obj = json::parse(json_request);
-        
-        std::unique_ptr<google::protobuf::Message> request(
-            m_message_factory->GetPrototype(m_current_method->input_type())->New()
-        );
-        
-        // Convert JSON to protobuf
-        std::string err;
-        google::protobuf::util::JsonStringToMessage(json_obj.dump(), request.get());
-        
-        // Serialize to protobuf format
-        std::string serialized;
-        request->SerializeToString(&serialized);
-        return serialized;
-    } catch (const json::parse_error& e) {
-        throw Error(ErrorCode::PARSE_ERROR, "Failed to parse JSON request: " + std::string(e.what()));
-    }
-}
-
-std::string GrpcHandler::deserializeResponse(const google::protobuf::Message* response) {
-    std::string json_string;
-    google::protobuf::util::JsonPrintOptions options;
-    options.add_whitespace = true;
-    options.always_print_primitive_fields = true;
-    google::protobuf::util::MessageToJsonString(*response, &json_string, options);
-    
-    try {
-        // Parse and re-serialize to ensure proper formatting
-        auto json_obj = json::parse(json_string);
-        return json_obj.dump(2);
-    } catch (const json::parse_error& e) {
-        throw Error(ErrorCode::PARSE_ERROR, "Failed to format response JSON: " + std::string(e.what()));
-    }
+    // Metadata is part of the plan, so calls never copy it from the handler
+    rebuildPlan();
 }
 
 } // namespace flowdriver 
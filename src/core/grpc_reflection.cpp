@@ -0,0 +1,272 @@
+#include "core/grpc_reflection.hpp"
+#include "core/error.hpp"
+#include "reflection.pb.h"
+#include <grpcpp/client_context.h>
+#include <grpcpp/completion_queue.h>
+#include <grpcpp/support/proto_buffer_reader.h>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <QDebug>
+
+namespace flowdriver {
+
+namespace {
+    // Tried in order, servers that only know v1alpha answer UNIMPLEMENTED to v1
+    constexpr const char* kReflectionMethods[] = {
+        "/grpc.reflection.v1.ServerReflection/ServerReflectionInfo",
+        "/grpc.reflection.v1alpha.ServerReflection/ServerReflectionInfo",
+    };
+
+    constexpr auto kReflectionTimeout = std::chrono::seconds(10);
+}
+
+/**
+ * @brief Descriptors received from one endpoint
+ */
+struct ReflectionClient::EndpointCache {
+    std::mutex mutex;
+    std::unordered_map<std::string, std::string> raw;  // Serialized FileDescriptorProto by file name
+    std::unordered_map<std::string, google::protobuf::FileDescriptorProto> files;
+};
+
+/**
+ * @brief Blocking ServerReflectionInfo stream on a private completion queue
+ *
+ * Reflection is a short request/response conversation done while the user
+ * picks a service, so it does not take a slot on the shared queues.
+ */
+class ReflectionClient::Stream {
+public:
+    Stream(grpc::GenericStub& stub, const std::string& method) {
+        context_.set_deadline(std::chrono::system_clock::now() + kReflectionTimeout);
+        call_ = stub.PrepareCall(&context_, method, &queue_);
+        call_->StartCall(this);
+        ok_ = wait();
+    }
+
+    ~Stream() {
+        finish();
+        queue_.Shutdown();
+        void* tag = nullptr;
+        bool ok = false;
+        while (queue_.Next(&tag, &ok)) {
+        }
+    }
+
+    std::optional<reflection::ServerReflectionResponse> exchange(const reflection::ServerReflectionRequest& request) {
+        if (!ok_) {
+            return std::nullopt;
+        }
+
+        grpc::Slice slice(request.SerializeAsString());
+        grpc::ByteBuffer outgoing(&slice, 1);
+        call_->Write(outgoing, this);
+        if (!wait()) {
+            ok_ = false;
+            return std::nullopt;
+        }
+
+        grpc::ByteBuffer incoming;
+        call_->Read(&incoming, this);
+        if (!wait()) {
+            ok_ = false;
+            return std::nullopt;
+        }
+
+        reflection::ServerReflectionResponse response;
+        grpc::ProtoBufferReader reader(&incoming);
+        if (!reader.status().ok() || !response.ParseFromZeroCopyStream(&reader)) {
+            throw Error(ErrorCode::PARSE_ERROR, "Failed to parse server reflection response");
+        }
+        return response;
+    }
+
+    grpc::Status finish() {
+        if (!finished_) {
+            finished_ = true;
+            if (ok_) {
+                call_->WritesDone(this);
+                wait();
+            }
+            call_->Finish(&status_, this);
+            wait();
+        }
+        return status_;
+    }
+
+private:
+    // Only one operation is ever outstanding, so the next event is its completion
+    bool wait() {
+        void* tag = nullptr;
+        bool ok = false;
+        return queue_.Next(&tag, &ok) && ok;
+    }
+
+    grpc::ClientContext context_;
+    grpc::CompletionQueue queue_;
+    std::unique_ptr<grpc::GenericClientAsyncReaderWriter> call_;
+    grpc::Status status_;
+    bool ok_{false};
+    bool finished_{false};
+};
+
+ReflectionClient::ReflectionClient(std::shared_ptr<grpc::Channel> channel, std::string endpoint)
+    : m_stub(std::move(channel))
+    , m_endpoint(std::move(endpoint))
+    , m_cache(cacheFor(m_endpoint))
+{
+}
+
+ReflectionClient::~ReflectionClient() = default;
+
+std::shared_ptr<ReflectionClient::EndpointCache> ReflectionClient::cacheFor(const std::string& endpoint) {
+    static std::mutex mutex;
+    static std::unordered_map<std::string, std::shared_ptr<EndpointCache>> caches;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& cache = caches[endpoint];
+    if (!cache) {
+        cache = std::make_shared<EndpointCache>();
+    }
+    return cache;
+}
+
+std::unique_ptr<ReflectionClient::Stream> ReflectionClient::open(const reflection::ServerReflectionRequest& request,
+                                                                 reflection::ServerReflectionResponse& response) {
+    std::vector<std::string> methods;
+    if (m_method.empty()) {
+        methods.assign(std::begin(kReflectionMethods), std::end(kReflectionMethods));
+    } else {
+        methods.push_back(m_method);
+    }
+
+    for (const auto& method : methods) {
+        auto stream = std::make_unique<Stream>(m_stub, method);
+        if (auto received = stream->exchange(request)) {
+            if (received->has_error_response()) {
+                throw Error(ErrorCode::PROTOCOL_ERROR,
+                            "Server reflection error: " + received->error_response().error_message());
+            }
+            m_method = method;
+            response = std::move(*received);
+            return stream;
+        }
+
+        auto status = stream->finish();
+        if (status.error_code() == grpc::StatusCode::DEADLINE_EXCEEDED) {
+            throw Error(ErrorCode::TIMEOUT, "Server reflection timed out");
+        }
+        if (status.error_code() != grpc::StatusCode::UNIMPLEMENTED) {
+            throw Error(ErrorCode::NETWORK_ERROR, "Server reflection failed: " + status.error_message());
+        }
+    }
+    throw Error(ErrorCode::PROTOCOL_ERROR, "Server reflection is not enabled on " + m_endpoint);
+}
+
+std::vector<std::string> ReflectionClient::listServices() {
+    reflection::ServerReflectionRequest request;
+    request.set_list_services("");
+
+    reflection::ServerReflectionResponse response;
+    auto stream = open(request, response);
+
+    std::vector<std::string> services;
+    for (const auto& service : response.list_services_response().service()) {
+        services.push_back(service.name());
+    }
+    return services;
+}
+
+ReflectionClient::ServiceDescriptors ReflectionClient::fetchService(const std::string& service) {
+    reflection::ServerReflectionRequest request;
+    request.set_file_containing_symbol(service);
+
+    reflection::ServerReflectionResponse response;
+    auto stream = open(request, response);
+
+    auto store = [this](const reflection::ServerReflectionResponse& received) {
+        for (const auto& raw : received.file_descriptor_response().file_descriptor_proto()) {
+            google::protobuf::FileDescriptorProto file;
+            if (!file.ParseFromString(raw)) {
+                throw Error(ErrorCode::PARSE_ERROR, "Invalid file descriptor from server reflection");
+            }
+            m_cache->raw[file.name()] = raw;
+            m_cache->files[file.name()] = std::move(file);
+        }
+    };
+
+    const auto& received = response.file_descriptor_response().file_descriptor_proto();
+    if (received.empty()) {
+        throw Error(ErrorCode::PROTOCOL_ERROR, "Server reflection returned no descriptor for " + service);
+    }
+
+    ServiceDescriptors result;
+    std::lock_guard<std::mutex> lock(m_cache->mutex);
+    {
+        // The file defining the symbol comes first, it doubles as the version check
+        google::protobuf::FileDescriptorProto root;
+        if (!root.ParseFromString(received[0])) {
+            throw Error(ErrorCode::PARSE_ERROR, "Invalid file descriptor from server reflection");
+        }
+        auto cached = m_cache->raw.find(root.name());
+        if (cached != m_cache->raw.end() && cached->second != received[0]) {
+            qDebug() << "Server reflection: descriptors of" << QString::fromStdString(m_endpoint)
+                     << "changed, dropping cache";
+            m_cache->raw.clear();
+            m_cache->files.clear();
+        }
+        result.file = root.name();
+    }
+    store(response);
+
+    // Fetch only the dependencies neither this stream nor an earlier one delivered
+    std::vector<std::string> pending{result.file};
+    std::unordered_set<std::string> visited;
+    while (!pending.empty()) {
+        auto name = std::move(pending.back());
+        pending.pop_back();
+        if (!visited.insert(name).second) {
+            continue;
+        }
+
+        if (!m_cache->files.contains(name)) {
+            reflection::ServerReflectionRequest by_name;
+            by_name.set_file_by_filename(name);
+            auto dependency = stream->exchange(by_name);
+            if (!dependency || dependency->has_error_response()) {
+                throw Error(ErrorCode::PROTOCOL_ERROR, "Server reflection could not provide " + name);
+            }
+            store(*dependency);
+            if (!m_cache->files.contains(name)) {
+                throw Error(ErrorCode::PROTOCOL_ERROR, "Server reflection could not provide " + name);
+            }
+        }
+        for (const auto& dependency : m_cache->files.at(name).dependency()) {
+            pending.push_back(dependency);
+        }
+    }
+
+    // Dependencies first, the order a FileDescriptorSet is expected in
+    std::unordered_set<std::string> added;
+    std::function<void(const std::string&)> add = [&](const std::string& name) {
+        if (!added.insert(name).second) {
+            return;
+        }
+        const auto& file = m_cache->files.at(name);
+        for (const auto& dependency : file.dependency()) {
+            add(dependency);
+        }
+        *result.descriptors.add_file() = file;
+    };
+    add(result.file);
+
+    qDebug() << "Server reflection: resolved" << QString::fromStdString(service) << "with"
+             << result.descriptors.file_size() << "files";
+    return result;
+}
+
+} // namespace flowdriver
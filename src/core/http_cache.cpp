@@ -0,0 +1,631 @@
+#include "core/http_cache.hpp"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <QDebug>
+
+namespace flowdriver {
+
+namespace {
+    constexpr char kDiskMagic[] = "FDHC1";
+
+    using clock = std::chrono::system_clock;
+
+    bool iequals(std::string_view a, std::string_view b) {
+        return a.size() == b.size() &&
+               std::equal(a.begin(), a.end(), b.begin(), [](char l, char r) {
+                   return std::tolower(static_cast<unsigned char>(l)) ==
+                          std::tolower(static_cast<unsigned char>(r));
+               });
+    }
+
+    std::string_view trim(std::string_view value) {
+        while (!value.empty() && std::isspace(static_cast<unsigned char>(value.front()))) {
+            value.remove_prefix(1);
+        }
+        while (!value.empty() && std::isspace(static_cast<unsigned char>(value.back()))) {
+            value.remove_suffix(1);
+        }
+        return value;
+    }
+
+    std::optional<std::string> findHeader(const std::vector<Header>& headers, std::string_view name) {
+        for (const auto& header : headers) {
+            if (iequals(header.name, name)) {
+                return header.value;
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::optional<std::chrono::seconds> parseSeconds(std::string_view value) {
+        value = trim(value);
+        if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
+            value = value.substr(1, value.size() - 2);
+        }
+        long long seconds = 0;
+        auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), seconds);
+        if (ec != std::errc() || ptr != value.data() + value.size() || seconds < 0) {
+            return std::nullopt;
+        }
+        return std::chrono::seconds(seconds);
+    }
+
+    // Parses IMF-fixdate, e.g. "Sun, 06 Nov 1994 08:49:37 GMT" (RFC 9110, section 5.6.7)
+    std::optional<clock::time_point> parseHttpDate(std::string_view value) {
+        static constexpr std::array<const char*, 12> months = {
+            "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"
+        };
+
+        std::string text(trim(value));
+        char month_name[4] = {};
+        std::tm tm{};
+        if (std::sscanf(text.c_str(), "%*3s, %2d %3s %4d %2d:%2d:%2d GMT",
+                        &tm.tm_mday, month_name, &tm.tm_year,
+                        &tm.tm_hour, &tm.tm_min, &tm.tm_sec) != 6) {
+            return std::nullopt;
+        }
+
+        auto month = std::find_if(months.begin(), months.end(), [&](const char* name) {
+            return iequals(name, month_name);
+        });
+        if (month == months.end()) {
+            return std::nullopt;
+        }
+        tm.tm_mon = static_cast<int>(month - months.begin());
+        tm.tm_year -= 1900;
+
+        return clock::from_time_t(timegm(&tm));
+    }
+
+    // Status codes that are heuristically cacheable (RFC 9110, section 15.1)
+    bool isHeuristicallyCacheable(int status_code) {
+        switch (status_code) {
+            case 200: case 203: case 204: case 206:
+            case 300: case 301: case 308:
+            case 404: case 405: case 410: case 414: case 501:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    std::vector<std::string> splitList(std::string_view value) {
+        std::vector<std::string> items;
+        while (!value.empty()) {
+            auto comma = value.find(',');
+            auto item = trim(value.substr(0, comma));
+            if (!item.empty()) {
+                items.emplace_back(item);
+            }
+            if (comma == std::string_view::npos) {
+                break;
+            }
+            value.remove_prefix(comma + 1);
+        }
+        return items;
+    }
+
+    std::string cacheKey(const RequestConfig& request) {
+        return request.url;
+    }
+
+    // Stable FNV-1a hash used for on-disk file names
+    std::string hashKey(std::string_view key) {
+        std::uint64_t hash = 14695981039346656037ull;
+        for (unsigned char c : key) {
+            hash ^= c;
+            hash *= 1099511628211ull;
+        }
+        char buffer[17];
+        std::snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(hash));
+        return buffer;
+    }
+
+    void writeString(std::ostream& out, std::string_view value) {
+        std::uint64_t size = value.size();
+        out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        out.write(value.data(), static_cast<std::streamsize>(value.size()));
+    }
+
+    bool readString(std::istream& in, std::string& value) {
+        std::uint64_t size = 0;
+        if (!in.read(reinterpret_cast<char*>(&size), sizeof(size))) {
+            return false;
+        }
+        value.resize(size);
+        return static_cast<bool>(in.read(value.data(), static_cast<std::streamsize>(size)));
+    }
+
+    void writeInt(std::ostream& out, std::int64_t value) {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    bool readInt(std::istream& in, std::int64_t& value) {
+        return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+    }
+
+    void writeHeaders(std::ostream& out, const std::vector<Header>& headers) {
+        writeInt(out, static_cast<std::int64_t>(headers.size()));
+        for (const auto& header : headers) {
+            writeString(out, header.name);
+            writeString(out, header.value);
+        }
+    }
+
+    bool readHeaders(std::istream& in, std::vector<Header>& headers) {
+        std::int64_t count = 0;
+        if (!readInt(in, count) || count < 0) {
+            return false;
+        }
+        headers.resize(static_cast<std::size_t>(count));
+        for (auto& header : headers) {
+            if (!readString(in, header.name) || !readString(in, header.value)) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+CacheControl CacheControl::parse(std::string_view value) {
+    CacheControl cc;
+    for (const auto& directive : splitList(value)) {
+        std::string_view name = directive;
+        std::string_view argument;
+        auto eq = name.find('=');
+        if (eq != std::string_view::npos) {
+            argument = name.substr(eq + 1);
+            name = trim(name.substr(0, eq));
+        }
+
+        if (iequals(name, "no-store")) {
+            cc.no_store = true;
+        } else if (iequals(name, "no-cache")) {
+            // A qualified no-cache only restricts listed fields; treat it as unqualified
+            cc.no_cache = true;
+        } else if (iequals(name, "must-revalidate")) {
+            cc.must_revalidate = true;
+        } else if (iequals(name, "public")) {
+            cc.is_public = true;
+        } else if (iequals(name, "private")) {
+            cc.is_private = true;
+        } else if (iequals(name, "immutable")) {
+            cc.immutable = true;
+        } else if (iequals(name, "max-age")) {
+            cc.max_age = parseSeconds(argument);
+        } else if (iequals(name, "min-fresh")) {
+            cc.min_fresh = parseSeconds(argument);
+        } else if (iequals(name, "max-stale")) {
+            cc.max_stale = argument.empty() ? std::chrono::seconds::max() : parseSeconds(argument);
+        }
+    }
+    return cc;
+}
+
+std::size_t CachedResponse::size() const {
+    std::size_t total = body.size();
+    for (const auto& header : headers) {
+        total += header.name.size() + header.value.size();
+    }
+    for (const auto& header : vary) {
+        total += header.name.size() + header.value.size();
+    }
+    return total;
+}
+
+std::optional<std::string> CachedResponse::header(std::string_view name) const {
+    return findHeader(headers, name);
+}
+
+// RFC 9111, section 4.2.3
+std::chrono::seconds CachedResponse::currentAge(clock::time_point now) const {
+    using std::chrono::duration_cast;
+    using std::chrono::seconds;
+
+    seconds age_value{0};
+    if (auto age = header("Age")) {
+        age_value = parseSeconds(*age).value_or(seconds{0});
+    }
+
+    seconds apparent_age{0};
+    if (auto date = header("Date")) {
+        if (auto date_value = parseHttpDate(*date)) {
+            apparent_age = std::max(seconds{0}, duration_cast<seconds>(response_time - *date_value));
+        }
+    }
+
+    auto response_delay = duration_cast<seconds>(response_time - request_time);
+    auto corrected_initial_age = std::max(apparent_age, age_value + response_delay);
+    auto resident_time = duration_cast<seconds>(now - response_time);
+    return corrected_initial_age + resident_time;
+}
+
+// RFC 9111, section 4.2.1
+std::chrono::seconds CachedResponse::freshnessLifetime() const {
+    using std::chrono::duration_cast;
+    using std::chrono::seconds;
+
+    auto cc = CacheControl::parse(header("Cache-Control").value_or(""));
+    if (cc.max_age) {
+        return *cc.max_age;
+    }
+
+    auto date = parseHttpDate(header("Date").value_or("")).value_or(response_time);
+    if (auto expires_header = header("Expires")) {
+        // Invalid Expires values mean "already expired"
+        auto expires = parseHttpDate(*expires_header);
+        if (!expires) {
+            return seconds{0};
+        }
+        return std::max(seconds{0}, duration_cast<seconds>(*expires - date));
+    }
+
+    // Heuristic freshness: 10% of the time since last modification (section 4.2.2)
+    if (isHeuristicallyCacheable(status_code)) {
+        if (auto last_modified = parseHttpDate(header("Last-Modified").value_or(""))) {
+            return std::max(seconds{0}, duration_cast<seconds>(date - *last_modified) / 10);
+        }
+    }
+    return seconds{0};
+}
+
+bool CachedResponse::hasValidators() const {
+    return header("ETag").has_value() || header("Last-Modified").has_value();
+}
+
+RequestResult CachedResponse::toResult(CacheStatus status) const {
+    RequestResult result;
+    result.status_code = status_code;
+    result.headers = headers;
+    result.body = body;
+    result.metrics.bytes_received = body.size();
+    result.cache_status = status;
+
+    auto age = currentAge(clock::now());
+    result.headers.erase(std::remove_if(result.headers.begin(), result.headers.end(),
+                                        [](const Header& h) { return iequals(h.name, "Age"); }),
+                         result.headers.end());
+    result.headers.push_back({"Age", std::to_string(age.count())});
+    return result;
+}
+
+HttpCache::HttpCache() : HttpCache(Options{}) {}
+
+HttpCache::HttpCache(Options options)
+    : m_options(std::move(options))
+{
+    if (m_options.disk_directory) {
+        std::error_code ec;
+        std::filesystem::create_directories(*m_options.disk_directory, ec);
+        if (ec) {
+            qDebug() << "HTTP cache: disk tier disabled:" << QString::fromStdString(ec.message());
+            m_options.disk_directory.reset();
+        }
+    }
+}
+
+HttpCache::~HttpCache() = default;
+
+bool HttpCache::isCacheableMethod(std::string_view method) {
+    return method == "GET";
+}
+
+bool HttpCache::isUnsafeMethod(std::string_view method) {
+    return method == "POST" || method == "PUT" || method == "DELETE" || method == "PATCH";
+}
+
+HttpCache::Lookup HttpCache::lookup(const RequestConfig& request) {
+    Lookup result;
+    if (!isCacheableMethod(request.method)) {
+        return result;
+    }
+
+    auto request_cc = CacheControl::parse(findHeader(request.headers, "Cache-Control").value_or(""));
+    if (request_cc.no_store) {
+        return result;
+    }
+
+    auto key = cacheKey(request);
+    std::shared_ptr<const CachedResponse> response;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_entries.find(key);
+        if (it != m_entries.end()) {
+            m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+            response = it->second.response;
+        }
+    }
+
+    if (!response && m_options.disk_directory) {
+        response = loadFromDisk(key);
+        if (response) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            insert(key, response);
+        }
+    }
+
+    if (!response) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_stats.misses;
+        return result;
+    }
+
+    // Vary: the selecting request headers must match (RFC 9111, section 4.1)
+    for (const auto& selected : response->vary) {
+        if (findHeader(request.headers, selected.name).value_or("") != selected.value) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ++m_stats.misses;
+            return result;
+        }
+    }
+
+    auto response_cc = CacheControl::parse(response->header("Cache-Control").value_or(""));
+    auto lifetime = response->freshnessLifetime();
+    auto age = response->currentAge(clock::now());
+    if (request_cc.min_fresh) {
+        age += *request_cc.min_fresh;
+    }
+    if (request_cc.max_age && *request_cc.max_age < lifetime) {
+        lifetime = *request_cc.max_age;
+    }
+
+    bool fresh = lifetime > age && !response_cc.no_cache && !request_cc.no_cache;
+
+    // An immutable response stays fresh for its whole lifetime, even when the
+    // request asks for revalidation as a reload does (RFC 8246)
+    if (!fresh && response_cc.immutable && !response_cc.no_cache &&
+        response->freshnessLifetime() > response->currentAge(clock::now())) {
+        fresh = true;
+    }
+
+    // max-stale lets the client take a stale response, but must-revalidate forbids reusing
+    // one without validating it first (RFC 9111, sections 5.2.1.2 and 5.2.2.2)
+    if (!fresh && request_cc.max_stale && !response_cc.must_revalidate &&
+        !response_cc.no_cache && !request_cc.no_cache && age - lifetime <= *request_cc.max_stale) {
+        fresh = true;
+    }
+
+    if (!fresh && !response->hasValidators()) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_stats.misses;
+        return result;
+    }
+
+    result.status = fresh ? LookupStatus::FRESH : LookupStatus::STALE;
+    result.response = std::move(response);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (fresh) {
+        ++m_stats.hits;
+    }
+    return result;
+}
+
+void HttpCache::addConditionalHeaders(const CachedResponse& cached, std::vector<Header>& headers) {
+    if (auto etag = cached.header("ETag")) {
+        headers.push_back({"If-None-Match", *etag});
+    }
+    if (auto last_modified = cached.header("Last-Modified")) {
+        headers.push_back({"If-Modified-Since", *last_modified});
+    }
+}
+
+void HttpCache::store(const RequestConfig& request, const RequestResult& result,
+                      clock::time_point request_time, clock::time_point response_time) {
+    if (!isCacheableMethod(request.method) || !result.error.empty()) {
+        return;
+    }
+    if (result.status_code < 200 || result.status_code == 206 || result.status_code == 304) {
+        return;
+    }
+
+    auto request_cc = CacheControl::parse(findHeader(request.headers, "Cache-Control").value_or(""));
+    auto response_cc = CacheControl::parse(findHeader(result.headers, "Cache-Control").value_or(""));
+    if (request_cc.no_store || response_cc.no_store) {
+        return;
+    }
+
+    auto response = std::make_shared<CachedResponse>();
+    response->status_code = result.status_code;
+    response->headers = result.headers;
+    response->body = result.body;
+    response->request_time = request_time;
+    response->response_time = response_time;
+
+    // Validators alone do not make a response storable (RFC 9111, section 3): it needs
+    // explicit freshness, public or private (this is a private cache) or a heuristically
+    // cacheable status
+    bool explicit_freshness = response_cc.max_age || response->header("Expires");
+    if (!explicit_freshness && !response_cc.is_public && !response_cc.is_private &&
+        !isHeuristicallyCacheable(result.status_code)) {
+        return;
+    }
+
+    if (auto vary = response->header("Vary")) {
+        for (const auto& name : splitList(*vary)) {
+            if (name == "*") {
+                return;
+            }
+            response->vary.push_back({name, findHeader(request.headers, name).value_or("")});
+        }
+    }
+
+    auto key = cacheKey(request);
+    if (m_options.disk_directory) {
+        saveToDisk(key, *response);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    insert(key, std::move(response));
+    ++m_stats.stores;
+}
+
+RequestResult HttpCache::revalidated(const RequestConfig& request, const CachedResponse& cached,
+                                     const RequestResult& not_modified,
+                                     clock::time_point request_time, clock::time_point response_time) {
+    // Update stored header fields from the 304 response (RFC 9111, section 4.3.4)
+    auto refreshed = std::make_shared<CachedResponse>(cached);
+    for (const auto& header : not_modified.headers) {
+        if (iequals(header.name, "Content-Length")) {
+            continue;
+        }
+        auto existing = std::find_if(refreshed->headers.begin(), refreshed->headers.end(),
+                                     [&](const Header& h) { return iequals(h.name, header.name); });
+        if (existing != refreshed->headers.end()) {
+            existing->value = header.value;
+        } else {
+            refreshed->headers.push_back(header);
+        }
+    }
+    refreshed->request_time = request_time;
+    refreshed->response_time = response_time;
+
+    auto result = refreshed->toResult(CacheStatus::REVALIDATED);
+    result.metrics = not_modified.metrics;
+    result.metrics.bytes_received = refreshed->body.size();
+
+    auto key = cacheKey(request);
+    if (m_options.disk_directory) {
+        saveToDisk(key, *refreshed);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    insert(key, std::move(refreshed));
+    ++m_stats.revalidations;
+    return result;
+}
+
+void HttpCache::invalidate(const std::string& url) {
+    if (m_options.disk_directory) {
+        std::error_code ec;
+        std::filesystem::remove(diskPath(url), ec);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(url);
+    if (it != m_entries.end()) {
+        m_bytes -= it->second.response->size();
+        m_lru.erase(it->second.lru);
+        m_entries.erase(it);
+    }
+}
+
+void HttpCache::clear() {
+    if (m_options.disk_directory) {
+        std::error_code ec;
+        for (const auto& file : std::filesystem::directory_iterator(*m_options.disk_directory, ec)) {
+            if (file.path().extension() == ".cache") {
+                std::filesystem::remove(file.path(), ec);
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+    m_lru.clear();
+    m_bytes = 0;
+}
+
+HttpCache::Stats HttpCache::stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats stats = m_stats;
+    stats.entries = m_entries.size();
+    stats.bytes = m_bytes;
+    return stats;
+}
+
+void HttpCache::insert(const std::string& key, std::shared_ptr<const CachedResponse> response) {
+    auto it = m_entries.find(key);
+    if (it != m_entries.end()) {
+        m_bytes -= it->second.response->size();
+        m_lru.erase(it->second.lru);
+        m_entries.erase(it);
+    }
+
+    // Entries larger than the whole budget only live on disk
+    if (response->size() > m_options.memory_budget) {
+        return;
+    }
+
+    m_lru.push_front(key);
+    m_bytes += response->size();
+    m_entries.emplace(key, Entry{std::move(response), m_lru.begin()});
+    evict();
+}
+
+void HttpCache::evict() {
+    while (m_bytes > m_options.memory_budget && !m_lru.empty()) {
+        auto it = m_entries.find(m_lru.back());
+        m_bytes -= it->second.response->size();
+        m_entries.erase(it);
+        m_lru.pop_back();
+        ++m_stats.evictions;
+    }
+}
+
+std::filesystem::path HttpCache::diskPath(const std::string& key) const {
+    return *m_options.disk_directory / (hashKey(key) + ".cache");
+}
+
+std::shared_ptr<const CachedResponse> HttpCache::loadFromDisk(const std::string& key) const {
+    std::ifstream in(diskPath(key), std::ios::binary);
+    if (!in) {
+        return nullptr;
+    }
+
+    char magic[sizeof(kDiskMagic)] = {};
+    std::string stored_key;
+    std::int64_t status = 0;
+    std::int64_t request_time = 0;
+    std::int64_t response_time = 0;
+    auto response = std::make_shared<CachedResponse>();
+
+    if (!in.read(magic, sizeof(magic)) || std::string_view(magic) != kDiskMagic ||
+        !readString(in, stored_key) || stored_key != key ||
+        !readInt(in, status) || !readInt(in, request_time) || !readInt(in, response_time) ||
+        !readHeaders(in, response->headers) || !readHeaders(in, response->vary) ||
+        !readString(in, response->body)) {
+        return nullptr;
+    }
+
+    response->status_code = static_cast<int>(status);
+    response->request_time = clock::time_point(clock::duration(request_time));
+    response->response_time = clock::time_point(clock::duration(response_time));
+    return response;
+}
+
+void HttpCache::saveToDisk(const std::string& key, const CachedResponse& response) const {
+    auto path = diskPath(key);
+    auto temp = path;
+    temp += ".tmp";
+
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            qDebug() << "HTTP cache: cannot write" << QString::fromStdString(temp.string());
+            return;
+        }
+        out.write(kDiskMagic, sizeof(kDiskMagic));
+        writeString(out, key);
+        writeInt(out, response.status_code);
+        writeInt(out, response.request_time.time_since_epoch().count());
+        writeInt(out, response.response_time.time_since_epoch().count());
+        writeHeaders(out, response.headers);
+        writeHeaders(out, response.vary);
+        writeString(out, response.body);
+    }
+
+    // Rename so readers never observe a partially written entry
+    std::error_code ec;
+    std::filesystem::rename(temp, path, ec);
+    if (ec) {
+        qDebug() << "HTTP cache: cannot store entry:" << QString::fromStdString(ec.message());
+    }
+}
+
+} // namespace flowdriver
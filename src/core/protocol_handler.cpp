@@ -1,9 +1,28 @@
 #include "core/protocol_handler.hpp"
 #include "core/error.hpp"
+#include "core/executor.hpp"
+#include <boost/asio/async_result.hpp>
+#include <boost/asio/associated_executor.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <exception>
+#include <memory>
 #include <stdexcept>
 
 namespace flowdriver {
 
+namespace {
+    boost::asio::awaitable<Expected<RequestResult>> catchErrors(boost::asio::awaitable<RequestResult> operation) {
+        try {
+            co_return co_await std::move(operation);
+        } catch (const Error& e) {
+            co_return std::unexpected(e);
+        } catch (const std::exception& e) {
+            co_return makeError(ErrorCode::UNKNOWN, e.what());
+        }
+    }
+}
+
 void ProtocolHandler::validateConfig(const RequestConfig& config) {
     if (config.url.empty()) {
         throw Error(ErrorCode::INVALID_CONFIG, "URL cannot be empty");
@@ -18,4 +37,71 @@ RequestResult ProtocolHandler::execute(const RequestConfig& config) {
     return future.get();
 }
 
-} // namespace flowdriver 
\ No newline at end of file
+Expected<RequestResult> ProtocolHandler::tryExecute(const RequestConfig& config) noexcept {
+    try {
+        return execute(config);
+    } catch (const Error& e) {
+        return std::unexpected(e);
+    } catch (const std::exception& e) {
+        return makeError(ErrorCode::UNKNOWN, e.what());
+    }
+}
+
+Expected<RawResult> ProtocolHandler::tryExecuteRaw(const RequestConfig& config, ResponseArena& arena) noexcept {
+    auto result = tryExecute(config);
+    if (!result) {
+        return std::unexpected(std::move(result.error()));
+    }
+    try {
+        return RawResult::fromResult(*result, arena);
+    } catch (const std::exception& e) {
+        return makeError(ErrorCode::UNKNOWN, e.what());
+    }
+}
+
+boost::asio::awaitable<Expected<RequestResult>> ProtocolHandler::co_tryExecute(const RequestConfig& config) {
+    // co_execute() copies the config before returning, so the caller's may go away
+    return catchErrors(co_execute(config));
+}
+
+boost::asio::awaitable<RequestResult> ProtocolHandler::co_execute(const RequestConfig& config) {
+    return offloadExecute(config);
+}
+
+boost::asio::awaitable<RequestResult> ProtocolHandler::offloadExecute(RequestConfig config) {
+    namespace net = boost::asio;
+
+    co_return co_await net::async_initiate<const net::use_awaitable_t<>&,
+                                           void(std::exception_ptr, RequestResult)>(
+        [this, &config](auto handler) {
+            auto work = net::get_associated_executor(handler);
+            // Shared so a rejected task does not take the handler down with it
+            auto pending = std::make_shared<decltype(handler)>(std::move(handler));
+            auto complete = [work, pending](std::exception_ptr error, RequestResult result) {
+                // Resume the awaiting coroutine on its own executor
+                net::post(work, [pending, error, result = std::move(result)]() mutable {
+                    std::move(*pending)(error, std::move(result));
+                });
+            };
+
+            // Called from I/O threads, which must never wait for queue space
+            bool queued = Executor::instance().tryPost([this, &config, complete]() mutable {
+                std::exception_ptr error;
+                RequestResult result;
+                try {
+                    result = execute(config);
+                } catch (...) {
+                    error = std::current_exception();
+                }
+                complete(error, std::move(result));
+            });
+            if (!queued) {
+                complete(std::make_exception_ptr(Error(ErrorCode::INVALID_STATE,
+                                                       "Executor queue is full, request rejected")),
+                         RequestResult{});
+            }
+        },
+        net::use_awaitable);
+}
+
+} // namespace flowdriver
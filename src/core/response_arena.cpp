@@ -0,0 +1,79 @@
+#include "core/response_arena.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+namespace flowdriver {
+
+namespace {
+    constexpr std::size_t kDefaultInitialSize = 64 * 1024;
+
+    bool iequals(std::string_view a, std::string_view b) {
+        return a.size() == b.size() &&
+               std::equal(a.begin(), a.end(), b.begin(), [](char l, char r) {
+                   return std::tolower(static_cast<unsigned char>(l)) ==
+                          std::tolower(static_cast<unsigned char>(r));
+               });
+    }
+}
+
+ResponseArena::ResponseArena() : ResponseArena(kDefaultInitialSize) {}
+
+ResponseArena::ResponseArena(std::size_t initial_size)
+    : m_initial(std::max<std::size_t>(initial_size, 1))
+    , m_resource(m_initial.data(), m_initial.size())
+{
+}
+
+std::string_view ResponseArena::copy(std::string_view data) {
+    if (data.empty()) {
+        return {};
+    }
+    auto* storage = static_cast<char*>(m_resource.allocate(data.size(), alignof(char)));
+    std::memcpy(storage, data.data(), data.size());
+    return {storage, data.size()};
+}
+
+void ResponseArena::reset() {
+    // Rewinds to the start of the initial block, later blocks go back upstream
+    m_resource.release();
+}
+
+std::optional<std::string_view> RawResult::header(std::string_view name) const {
+    for (const auto& header : headers) {
+        if (iequals(header.name, name)) {
+            return header.value;
+        }
+    }
+    return std::nullopt;
+}
+
+RequestResult RawResult::materialize() const {
+    RequestResult result;
+    result.status_code = status_code;
+    result.headers.reserve(headers.size());
+    for (const auto& header : headers) {
+        result.headers.push_back({std::string(header.name), std::string(header.value)});
+    }
+    result.body = std::string(body);
+    result.error = std::string(error);
+    result.metrics = metrics;
+    result.cache_status = cache_status;
+    return result;
+}
+
+RawResult RawResult::fromResult(const RequestResult& result, ResponseArena& arena) {
+    RawResult raw(arena);
+    raw.status_code = result.status_code;
+    raw.headers.reserve(result.headers.size());
+    for (const auto& header : result.headers) {
+        raw.headers.push_back({arena.copy(header.name), arena.copy(header.value)});
+    }
+    raw.body = arena.copy(result.body);
+    raw.error = arena.copy(result.error);
+    raw.metrics = result.metrics;
+    raw.cache_status = result.cache_status;
+    return raw;
+}
+
+} // namespace flowdriver
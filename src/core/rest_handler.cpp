@@ -1,5 +1,7 @@
 #include "core/rest_handler.hpp"
 #include "core/error.hpp"
+#include "core/http_cache.hpp"
+#include "core/executor.hpp"
 #include <boost/beast/http.hpp>
 #include <boost/beast/core.hpp>
 #include <boost/beast/ssl.hpp>
@@ -9,8 +11,15 @@
 #include <boost/asio/error.hpp>
 #include <boost/asio/ssl/stream.hpp>
 #include <boost/asio/strand.hpp>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/redirect_error.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/asio/use_future.hpp>
 #include <variant>
+#include <atomic>
 #include <chrono>
+#include <mutex>
+#include <unordered_set>
 #include <QDebug>
 
 namespace beast = boost::beast;
@@ -22,6 +31,10 @@ namespace flowdriver {
 
 using ssl_stream_t = beast::ssl_stream<beast::tcp_stream>;
 using stream_variant_t = std::variant<beast::tcp_stream*, ssl_stream_t*>;
+using arena_alloc_t = ArenaAllocator<char>;
+using arena_response_t = http::response<
+    http::basic_string_body<char, std::char_traits<char>, arena_alloc_t>,
+    http::basic_fields<arena_alloc_t>>;
 
 // Add this helper function before the RestHandler class implementation
 std::tuple<std::string, std::string, std::string> parseUrl(const std::string& url) {
@@ -89,12 +102,11 @@ namespace {
     }
 }
 
-class RestHandler::Impl {
+class RestHandler::Impl : public std::enable_shared_from_this<Impl> {
     friend class RestHandler;
 public:
     Impl() 
-        : ioc_()
-        , work_guard_(net::make_work_guard(ioc_)) {
+        : ioc_(Executor::instance().ioContext()) {
         
         qDebug() << "Initializing SSL context...";
         
@@ -107,142 +119,494 @@ public:
     }
 
     std::future<RequestResult> executeAsync(const RequestConfig& config) {
-        return std::async(std::launch::async, [this, config]() {
+        // Thin adapter over the coroutine path, driven by the shared I/O pool
+        return net::co_spawn(Executor::instance().ioContext(),
+                             co_perform(shared_from_this(), config),
+                             net::use_future);
+    }
+
+    Expected<RequestResult> tryPerform(const RequestConfig& config) noexcept {
+        try {
+            CacheLookup lookup;
+            if (auto cached = beginCached(config, lookup)) {
+                return std::move(*cached);
+            }
+
+            auto request_time = std::chrono::system_clock::now();
+            auto result = trySend(lookup.outgoing);
+            if (!result) {
+                return result;
+            }
+            return finishCached(config, lookup, std::move(*result), request_time);
+        } catch (const std::exception& e) {
+            return makeError(ErrorCode::UNKNOWN, e.what());
+        }
+    }
+
+    Expected<RawResult> tryPerformRaw(const RequestConfig& config, ResponseArena& arena) noexcept {
+        if (cache_.load() && !config.bypass_cache) {
+            // The cache stores owning copies anyway, go through the regular path
+            auto result = tryPerform(config);
+            if (!result) {
+                return std::unexpected(std::move(result.error()));
+            }
             try {
-                qDebug() << "Executing request:" << QString::fromStdString(config.url);
+                return RawResult::fromResult(*result, arena);
+            } catch (const std::exception& e) {
+                return makeError(ErrorCode::UNKNOWN, e.what());
+            }
+        }
+        return trySendRaw(config, arena);
+    }
+
+    /**
+     * @brief Never throws, benchmark coroutines rely on every failure arriving as an Error
+     *
+     * The frame holds on to the Impl, so a call in flight outlives the
+     * RestHandler it was started from.
+     */
+    static net::awaitable<Expected<RequestResult>> co_tryPerform(std::shared_ptr<Impl> self, RequestConfig config) {
+        // Each call runs on its own strand, so cancel() can reach its sockets safely
+        auto call = std::make_shared<ActiveCall>(net::make_strand(self->ioc_));
+        self->track(call);
+        struct Untrack {
+            Impl& impl;
+            const std::shared_ptr<ActiveCall>& call;
+            ~Untrack() { impl.untrack(call); }
+        } untrack{*self, call};
+
+        co_return co_await net::co_spawn(call->strand, self->co_tryRun(std::move(config), call), net::use_awaitable);
+    }
+
+    static net::awaitable<RequestResult> co_perform(std::shared_ptr<Impl> self, RequestConfig config) {
+        co_return valueOrThrow(co_await co_tryPerform(std::move(self), std::move(config)));
+    }
+
+    // Aborts the coroutine calls in flight, blocking calls run to completion
+    void cancel() {
+        std::lock_guard<std::mutex> lock(calls_mutex_);
+        for (const auto& call : calls_) {
+            net::post(call->strand, [call]() {
+                call->cancelled = true;
+                if (call->abort) {
+                    call->abort();
+                }
+            });
+        }
+    }
+
+    void setSSLContext(std::shared_ptr<ssl::context> ctx) {
+        ssl_ctx_ = ctx;
+    }
+
+    void setCache(std::shared_ptr<HttpCache> cache) {
+        cache_.store(std::move(cache));
+    }
+
+private:
+    /**
+     * @brief A coroutine call in flight; all but the strand are only touched on it
+     */
+    struct ActiveCall {
+        explicit ActiveCall(net::strand<net::io_context::executor_type> s) : strand(std::move(s)) {}
+
+        net::strand<net::io_context::executor_type> strand;
+        bool cancelled{false};
+        std::function<void()> abort;  // Cancels the resolver or stream currently in use
+    };
+
+    void track(const std::shared_ptr<ActiveCall>& call) {
+        std::lock_guard<std::mutex> lock(calls_mutex_);
+        calls_.insert(call);
+    }
+
+    void untrack(const std::shared_ptr<ActiveCall>& call) {
+        std::lock_guard<std::mutex> lock(calls_mutex_);
+        calls_.erase(call);
+    }
+
+    net::awaitable<Expected<RequestResult>> co_tryRun(RequestConfig config, std::shared_ptr<ActiveCall> call) {
+        try {
+            CacheLookup lookup;
+            if (auto cached = beginCached(config, lookup)) {
+                co_return std::move(*cached);
+            }
+
+            auto request_time = std::chrono::system_clock::now();
+            auto result = co_await co_trySend(lookup.outgoing, *call);
+            if (!result) {
+                co_return result;
+            }
+            co_return finishCached(config, lookup, std::move(*result), request_time);
+        } catch (const std::exception& e) {
+            qDebug() << "General error:" << e.what();
+            co_return makeError(ErrorCode::UNKNOWN, e.what());
+        }
+    }
+
+    struct CacheLookup {
+        std::shared_ptr<HttpCache> cache;
+        HttpCache::Lookup entry;
+        RequestConfig outgoing;
+    };
+
+    // Returns the response when it can be served without contacting the origin
+    std::optional<RequestResult> beginCached(const RequestConfig& config, CacheLookup& lookup) {
+        lookup.outgoing = config;
+        if (config.bypass_cache) {
+            return std::nullopt;
+        }
+
+        // The cache may be swapped while requests are in flight, each one sticks to its own
+        lookup.cache = cache_.load();
+        if (!lookup.cache || !HttpCache::isCacheableMethod(config.method)) {
+            return std::nullopt;
+        }
+
+        lookup.entry = lookup.cache->lookup(config);
+        if (lookup.entry.status == HttpCache::LookupStatus::FRESH) {
+            qDebug() << "Serving from cache:" << QString::fromStdString(config.url);
+            return lookup.entry.response->toResult(CacheStatus::HIT);
+        }
+
+        if (lookup.entry.status == HttpCache::LookupStatus::STALE) {
+            HttpCache::addConditionalHeaders(*lookup.entry.response, lookup.outgoing.headers);
+        }
+        return std::nullopt;
+    }
+
+    RequestResult finishCached(const RequestConfig& config, const CacheLookup& lookup,
+                               RequestResult result,
+                               std::chrono::system_clock::time_point request_time) {
+        if (!lookup.cache) {
+            return result;
+        }
+
+        auto response_time = std::chrono::system_clock::now();
+        if (!HttpCache::isCacheableMethod(config.method)) {
+            // Successful unsafe requests invalidate the stored target (RFC 9111, section 4.4)
+            if (HttpCache::isUnsafeMethod(config.method) &&
+                result.status_code >= 200 && result.status_code < 400) {
+                lookup.cache->invalidate(config.url);
+            }
+            return result;
+        }
+
+        if (result.status_code == 304 && lookup.entry.response) {
+            qDebug() << "Cache entry revalidated:" << QString::fromStdString(config.url);
+            return lookup.cache->revalidated(config, *lookup.entry.response, result,
+                                             request_time, response_time);
+        }
+
+        lookup.cache->store(config, result, request_time, response_time);
+        result.cache_status = CacheStatus::MISS;
+        return result;
+    }
+
+    static http::request<http::string_body> buildRequest(const RequestConfig& config,
+                                                         const std::string& host,
+                                                         const std::string& target) {
+        http::request<http::string_body> req{
+            http::string_to_verb(config.method),
+            target,
+            11  // HTTP/1.1
+        };
+
+        req.set(http::field::host, host);
+        req.set(http::field::user_agent, "FlowDriver/1.0");
+
+        // Add headers
+        for (const auto& header : config.headers) {
+            req.set(header.name, header.value);
+        }
+
+        // Add body if present
+        if (!config.body.empty()) {
+            req.body() = config.body;
+            req.prepare_payload();
+        }
+        return req;
+    }
+
+    static RequestResult toResult(http::response<http::string_body>& res) {
+        RequestResult result;
+        result.status_code = res.result_int();
+        result.body = std::move(res.body());
+
+        for (const auto& header : res) {
+            result.headers.push_back({
+                std::string(header.name_string()),
+                std::string(header.value())
+            });
+        }
+        return result;
+    }
+
+    static beast::error_code setSniHostname(ssl_stream_t& stream, const std::string& host) {
+        if (!SSL_set_tlsext_host_name(stream.native_handle(), host.c_str())) {
+            return beast::error_code(static_cast<int>(::ERR_get_error()),
+                                     net::error::get_ssl_category());
+        }
+        return {};
+    }
 
-                auto [host, port, target] = parseUrl(config.url);
-                bool use_ssl = config.url.substr(0, 8) == "https://";  // Исправил проверку HTTPS
+    static void logShutdown(const beast::error_code& ec) {
+        if(ec &&
+             ec != beast::errc::not_connected &&
+             ec != net::error::eof &&
+             ec.category() != net::ssl::error::get_stream_category()) {
+            qDebug() << "SSL shutdown unexpected error:" << ec.message().c_str();
+        } else {
+            qDebug() << "SSL connection closed cleanly";
+        }
+    }
+
+    static std::unexpected<Error> cancelledError() {
+        return makeError(ErrorCode::NETWORK_ERROR, "Request cancelled");
+    }
+
+    static std::unexpected<Error> networkError(const char* step, const beast::error_code& ec) {
+        qDebug() << "Beast error:" << step << ec.message().c_str();
+        auto code = ec == beast::error::timeout ? ErrorCode::TIMEOUT : ErrorCode::NETWORK_ERROR;
+        return makeError(code, std::string(step) + ": " + ec.message());
+    }
+
+    Expected<RequestResult> trySend(const RequestConfig& config) noexcept {
+        beast::flat_buffer buffer;
+        http::response<http::string_body> res;
+        auto done = exchange(config, res, buffer);
+        if (!done) {
+            return std::unexpected(std::move(done.error()));
+        }
+        return toResult(res);
+    }
+
+    // Parses straight into the arena, the response object is never destroyed
+    // so the views handed out stay valid until the arena is reset
+    Expected<RawResult> trySendRaw(const RequestConfig& config, ResponseArena& arena) noexcept {
+        try {
+            arena_alloc_t alloc(arena);
+            auto* res = arena.create<arena_response_t>(std::piecewise_construct,
+                                                       std::make_tuple(alloc),
+                                                       std::make_tuple(alloc));
+            beast::basic_flat_buffer<arena_alloc_t> buffer(alloc);
+            auto done = exchange(config, *res, buffer);
+            if (!done) {
+                return std::unexpected(std::move(done.error()));
+            }
+
+            RawResult result(arena);
+            result.status_code = res->result_int();
+            result.body = std::string_view(res->body().data(), res->body().size());
+            for (const auto& header : *res) {
+                auto name = header.name_string();
+                auto value = header.value();
+                result.headers.push_back({std::string_view(name.data(), name.size()),
+                                          std::string_view(value.data(), value.size())});
+            }
+            return result;
+        } catch (const std::exception& e) {
+            return makeError(ErrorCode::UNKNOWN, e.what());
+        }
+    }
 
-                qDebug() << "Parsed URL - Host:" << QString::fromStdString(host)
-                         << "Port:" << QString::fromStdString(port)
-                         << "Target:" << QString::fromStdString(target)
-                         << "SSL:" << use_ssl;
+    // Uses the error_code overloads throughout so failures never unwind
+    template<typename Response, typename Buffer>
+    Expected<void> exchange(const RequestConfig& config, Response& res, Buffer& buffer) noexcept {
+        try {
+            qDebug() << "Executing request:" << QString::fromStdString(config.url);
+
+            auto [host, port, target] = parseUrl(config.url);
+            bool use_ssl = config.url.substr(0, 8) == "https://";  // Исправил проверку HTTPS
+
+            qDebug() << "Parsed URL - Host:" << QString::fromStdString(host)
+                     << "Port:" << QString::fromStdString(port)
+                     << "Target:" << QString::fromStdString(target)
+                     << "SSL:" << use_ssl;
+
+            auto req = buildRequest(config, host, target);
+            beast::error_code ec;
+
+            // Create stream
+            beast::tcp_stream base_stream(ioc_);
+            std::unique_ptr<beast::ssl_stream<beast::tcp_stream>> ssl_stream;
+
+            // Resolve endpoint
+            qDebug() << "Resolving hostname...";
+            auto resolver = net::ip::tcp::resolver(ioc_);
+            auto const endpoints = resolver.resolve(host, port, ec);
+            if (ec) {
+                return networkError("resolve", ec);
+            }
+            qDebug() << "Resolved" << endpoints.size() << "endpoints";
 
-                          // Create request
-                http::request<http::string_body> req{
-                    http::string_to_verb(config.method),
-                    target,
-                    11  // HTTP/1.1
-                };
+            if (use_ssl) {
+                qDebug() << "Setting up SSL stream...";
+                ssl_stream = std::make_unique<beast::ssl_stream<beast::tcp_stream>>(
+                    std::move(base_stream), *ssl_ctx_);
 
-                req.set(http::field::host, host);
-                req.set(http::field::user_agent, "FlowDriver/1.0");
+                qDebug() << "Setting SNI hostname:" << QString::fromStdString(host);
+                if ((ec = setSniHostname(*ssl_stream, host))) {
+                    return networkError("Failed to set SNI Hostname", ec);
+                }
 
-                          // Add headers
-                for (const auto& header : config.headers) {
-                    req.set(header.name, header.value);
+                qDebug() << "Connecting to endpoint...";
+                beast::get_lowest_layer(*ssl_stream).connect(endpoints, ec);
+                if (ec) {
+                    return networkError("connect", ec);
                 }
 
-                          // Add body if present
-                if (!config.body.empty()) {
-                    req.body() = config.body;
-                    req.prepare_payload();
+                qDebug() << "Starting SSL handshake...";
+                ssl_stream->handshake(ssl::stream_base::client, ec);
+                if (ec) {
+                    return networkError("handshake", ec);
                 }
+                qDebug() << "SSL handshake completed successfully";
 
-                          // Create stream
-                beast::tcp_stream base_stream(ioc_);
-                std::unique_ptr<beast::ssl_stream<beast::tcp_stream>> ssl_stream;
-
-                          // Resolve endpoint
-                qDebug() << "Resolving hostname...";
-                auto resolver = net::ip::tcp::resolver(ioc_);
-                auto const endpoints = resolver.resolve(host, port);
-                qDebug() << "Resolved" << endpoints.size() << "endpoints";
-
-                          // Buffer for response
-                beast::flat_buffer buffer;
-                http::response<http::string_body> res;
-
-                if (use_ssl) {
-                    qDebug() << "Setting up SSL stream...";
-                    ssl_stream = std::make_unique<beast::ssl_stream<beast::tcp_stream>>(
-                        std::move(base_stream), *ssl_ctx_);
-
-                    qDebug() << "Setting SNI hostname:" << QString::fromStdString(host);
-                    if (!SSL_set_tlsext_host_name(ssl_stream->native_handle(), host.c_str())) {
-                        throw beast::system_error(
-                            beast::error_code(
-                                static_cast<int>(::ERR_get_error()),
-                                net::error::get_ssl_category()),
-                            "Failed to set SNI Hostname");
-                    }
-
-                    qDebug() << "Connecting to endpoint...";
-                    beast::get_lowest_layer(*ssl_stream).connect(endpoints);
-
-                    qDebug() << "Starting SSL handshake...";
-                    ssl_stream->handshake(ssl::stream_base::client);
-                    qDebug() << "SSL handshake completed successfully";
-
-                    // Dump certificate info
-                    dump_cert_info(ssl_stream->native_handle());
-
-                    qDebug() << "Writing request...";
-                    http::write(*ssl_stream, req);
-
-                    qDebug() << "Reading response...";
-                    http::read(*ssl_stream, buffer, res);
-
-                    qDebug() << "Starting SSL shutdown...";
-                    beast::error_code ec;
-                    ssl_stream->shutdown(ec);
-
-                    if(ec &&
-                         ec != beast::errc::not_connected &&
-                         ec != net::error::eof &&
-                         ec.category() != net::ssl::error::get_stream_category()) {
-                        qDebug() << "SSL shutdown unexpected error:" << ec.message().c_str();
-                    } else {
-                        qDebug() << "SSL connection closed cleanly";
-                    }
-                } else {
-                    qDebug() << "Connecting non-SSL stream...";
-                    base_stream.connect(endpoints);
-
-                    qDebug() << "Writing request...";
-                    http::write(base_stream, req);
-
-                    qDebug() << "Reading response...";
-                    http::read(base_stream, buffer, res);
+                // Dump certificate info
+                dump_cert_info(ssl_stream->native_handle());
+
+                qDebug() << "Writing request...";
+                http::write(*ssl_stream, req, ec);
+                if (ec) {
+                    return networkError("write", ec);
                 }
 
-                          // Prepare result
-                RequestResult result;
-                result.status_code = res.result_int();
-                result.body = res.body();
+                qDebug() << "Reading response...";
+                http::read(*ssl_stream, buffer, res, ec);
+                if (ec) {
+                    return networkError("read", ec);
+                }
 
-                for (const auto& header : res) {
-                    result.headers.push_back({
-                        std::string(header.name_string()),
-                        std::string(header.value())
-                    });
+                qDebug() << "Starting SSL shutdown...";
+                ssl_stream->shutdown(ec);
+                logShutdown(ec);
+            } else {
+                qDebug() << "Connecting non-SSL stream...";
+                base_stream.connect(endpoints, ec);
+                if (ec) {
+                    return networkError("connect", ec);
                 }
 
-                return result;
+                qDebug() << "Writing request...";
+                http::write(base_stream, req, ec);
+                if (ec) {
+                    return networkError("write", ec);
+                }
 
-            } catch (const beast::system_error& e) {
-                qDebug() << "Beast error:" << e.what();
-                throw Error(ErrorCode::NETWORK_ERROR, e.what());
-            } catch (const std::exception& e) {
-                qDebug() << "General error:" << e.what();
-                throw Error(ErrorCode::UNKNOWN, e.what());
+                qDebug() << "Reading response...";
+                http::read(base_stream, buffer, res, ec);
+                if (ec) {
+                    return networkError("read", ec);
+                }
             }
-        });
+
+            return {};
+
+        } catch (const std::exception& e) {
+            qDebug() << "General error:" << e.what();
+            return makeError(ErrorCode::UNKNOWN, e.what());
+        }
     }
 
-    void setSSLContext(std::shared_ptr<ssl::context> ctx) {
-        ssl_ctx_ = ctx;
+    // Same exchange as trySend(), suspended on the call's strand instead of blocking
+    net::awaitable<Expected<RequestResult>> co_trySend(RequestConfig config, ActiveCall& call) {
+        // Beast throws on an unknown verb when the request is built
+        if (http::string_to_verb(config.method) == http::verb::unknown) {
+            co_return makeError(ErrorCode::INVALID_ARGUMENT, "Unsupported HTTP method: " + config.method);
+        }
+
+        auto executor = co_await net::this_coro::executor;
+        auto [host, port, target] = parseUrl(config.url);
+        bool use_ssl = config.url.substr(0, 8) == "https://";
+        auto req = buildRequest(config, host, target);
+        beast::error_code ec;
+        auto on_error = net::redirect_error(net::use_awaitable, ec);
+        if (call.cancelled) {
+            co_return cancelledError();
+        }
+
+        // Cleared before the resolver and streams below go away
+        struct ClearAbort {
+            ActiveCall& call;
+            ~ClearAbort() { call.abort = nullptr; }
+        } clear_abort{call};
+        auto fail = [&call](const char* step, const beast::error_code& error) {
+            return call.cancelled ? cancelledError() : networkError(step, error);
+        };
+
+        net::ip::tcp::resolver resolver(executor);
+        call.abort = [&resolver]() { resolver.cancel(); };
+        auto const endpoints = co_await resolver.async_resolve(host, port, on_error);
+        if (ec || call.cancelled) {
+            co_return fail("resolve", ec);
+        }
+
+        beast::flat_buffer buffer;
+        http::response<http::string_body> res;
+
+        if (use_ssl) {
+            ssl_stream_t stream(executor, *ssl_ctx_);
+            call.abort = [&stream]() { beast::get_lowest_layer(stream).cancel(); };
+            if ((ec = setSniHostname(stream, host))) {
+                co_return networkError("Failed to set SNI Hostname", ec);
+            }
+
+            beast::get_lowest_layer(stream).expires_after(config.timeout);
+            co_await beast::get_lowest_layer(stream).async_connect(endpoints, on_error);
+            if (ec) {
+                co_return fail("connect", ec);
+            }
+            co_await stream.async_handshake(ssl::stream_base::client, on_error);
+            if (ec) {
+                co_return fail("handshake", ec);
+            }
+
+            beast::get_lowest_layer(stream).expires_after(config.timeout);
+            co_await http::async_write(stream, req, on_error);
+            if (ec) {
+                co_return fail("write", ec);
+            }
+            co_await http::async_read(stream, buffer, res, on_error);
+            if (ec) {
+                co_return fail("read", ec);
+            }
+
+            co_await stream.async_shutdown(on_error);
+            logShutdown(ec);
+        } else {
+            beast::tcp_stream stream(executor);
+            call.abort = [&stream]() { stream.cancel(); };
+
+            stream.expires_after(config.timeout);
+            co_await stream.async_connect(endpoints, on_error);
+            if (ec) {
+                co_return fail("connect", ec);
+            }
+            co_await http::async_write(stream, req, on_error);
+            if (ec) {
+                co_return fail("write", ec);
+            }
+            co_await http::async_read(stream, buffer, res, on_error);
+            if (ec) {
+                co_return fail("read", ec);
+            }
+
+            stream.socket().shutdown(net::ip::tcp::socket::shutdown_both, ec);
+        }
+
+        co_return toResult(res);
     }
 
-private:
-    net::io_context ioc_;
+    net::io_context& ioc_;  // Shared I/O pool, streams only use its executor
     std::shared_ptr<ssl::context> ssl_ctx_;
-    net::executor_work_guard<net::io_context::executor_type> work_guard_;
+    std::atomic<std::shared_ptr<HttpCache>> cache_;
+    std::mutex calls_mutex_;
+    std::unordered_set<std::shared_ptr<ActiveCall>> calls_;
 };
 
 // Implementation of public interface
-RestHandler::RestHandler() : pimpl_(std::make_unique<Impl>()) {}
+RestHandler::RestHandler() : pimpl_(std::make_shared<Impl>()) {}
 RestHandler::~RestHandler() = default;
 
 std::future<RequestResult> RestHandler::executeAsync(const RequestConfig& config) {
@@ -250,7 +614,24 @@ std::future<RequestResult> RestHandler::executeAsync(const RequestConfig& config
 }
 
 RequestResult RestHandler::execute(const RequestConfig& config) {
-    return executeAsync(config).get();
+    // Run on the calling thread so synchronous callers never wait on the shared pool
+    return valueOrThrow(pimpl_->tryPerform(config));
+}
+
+Expected<RequestResult> RestHandler::tryExecute(const RequestConfig& config) noexcept {
+    return pimpl_->tryPerform(config);
+}
+
+Expected<RawResult> RestHandler::tryExecuteRaw(const RequestConfig& config, ResponseArena& arena) noexcept {
+    return pimpl_->tryPerformRaw(config, arena);
+}
+
+net::awaitable<RequestResult> RestHandler::co_execute(const RequestConfig& config) {
+    return Impl::co_perform(pimpl_, config);
+}
+
+net::awaitable<Expected<RequestResult>> RestHandler::co_tryExecute(const RequestConfig& config) {
+    return Impl::co_tryPerform(pimpl_, config);
 }
 
 void RestHandler::setSSLContext(std::shared_ptr<ssl::context> ctx) {
@@ -259,8 +640,16 @@ void RestHandler::setSSLContext(std::shared_ptr<ssl::context> ctx) {
     }
 }
 
+void RestHandler::setCache(std::shared_ptr<HttpCache> cache) {
+    pimpl_->setCache(std::move(cache));
+}
+
+std::shared_ptr<HttpCache> RestHandler::cache() const {
+    return pimpl_->cache_.load();
+}
+
 void RestHandler::cancel() {
-    // Implement if needed
+    pimpl_->cancel();
 }
 
 } // namespace flowdriver 
@@ -1,5 +1,6 @@
 #include "core/websocket_handler.hpp"
 #include "core/error.hpp"
+#include "core/executor.hpp"
 #include <boost/beast/core.hpp>
 #include <boost/beast/websocket.hpp>
 #include <boost/beast/ssl.hpp>
@@ -9,6 +10,8 @@
 #include <boost/asio/buffer.hpp>
 #include <optional>
 #include <iostream>
+#include <condition_variable>
+#include <mutex>
 
 namespace beast = boost::beast;
 namespace websocket = beast::websocket;
@@ -21,11 +24,9 @@ namespace flowdriver {
 class WebSocketHandler::Impl {
 public:
     Impl() 
-        : ioc_()
+        : ioc_(Executor::instance().ioContext())
         , ssl_ctx_(ssl::context::tlsv12_client)
         , resolver_(ioc_)
-        , work_guard_(net::make_work_guard(ioc_))
-        , io_thread_([this] { ioc_.run(); }) 
     {
         ssl_ctx_.set_verify_mode(ssl::verify_peer);
         ssl_ctx_.set_default_verify_paths();
@@ -33,10 +34,22 @@ public:
 
     ~Impl() {
         close();
-        work_guard_.reset();
-        if (io_thread_.joinable()) {
-            io_thread_.join();
-        }
+
+        // The read loop runs on the shared I/O pool; make sure it has finished
+        // before the stream and buffers it references are destroyed. Closing the
+        // socket completes any pending read, so the wait is bounded by the pool
+        // running the close, never by the peer.
+        net::post(ioc_, [this]() {
+            std::visit([](auto& ws) {
+                if (ws) {
+                    boost::system::error_code ec;
+                    beast::get_lowest_layer(*ws).socket().close(ec);
+                }
+            }, ws_);
+        });
+
+        std::unique_lock<std::mutex> lock(read_mutex_);
+        read_done_.wait(lock, [this]() { return !reading_; });
     }
 
     void connect(const RequestConfig& config) {
@@ -147,37 +160,44 @@ public:
         }
     }
 
-    RequestResult execute(const RequestConfig& config) {
+    Expected<RequestResult> tryExecute(const RequestConfig& config) noexcept {
         if (ws_.valueless_by_exception() || !std::visit([](const auto& ws) { return ws != nullptr; }, ws_)) {
-            throw Error(ErrorCode::NETWORK_ERROR, "WebSocket not connected");
+            return makeError(ErrorCode::NETWORK_ERROR, "WebSocket not connected");
         }
 
         try {
-            std::visit([&config](auto& ws) {
+            boost::system::error_code ec;
+            std::visit([&config, &ec](auto& ws) {
                 if (!config.body.empty()) {
-                    ws->write(boost::asio::buffer(config.body));
+                    ws->write(boost::asio::buffer(config.body), ec);
                 } else {
-                    ws->write(boost::asio::buffer("")); // Send empty string if no body
+                    ws->write(boost::asio::buffer(""), ec); // Send empty string if no body
                 }
             }, ws_);
+            if (ec) {
+                return makeError(ErrorCode::NETWORK_ERROR, ec.message());
+            }
 
             beast::flat_buffer buffer;
-            std::visit([&buffer](auto& ws) {
-                ws->read(buffer);
+            std::visit([&buffer, &ec](auto& ws) {
+                ws->read(buffer, ec);
             }, ws_);
+            if (ec) {
+                return makeError(ErrorCode::NETWORK_ERROR, ec.message());
+            }
 
             RequestResult result;
             result.status_code = 200;
             result.body = beast::buffers_to_string(buffer.data());
             return result;
-        } catch (const boost::system::system_error& e) {
-            throw Error(ErrorCode::NETWORK_ERROR, e.what());
+        } catch (const std::exception& e) {
+            return makeError(ErrorCode::UNKNOWN, std::string("Unexpected error: ") + e.what());
         }
     }
 
     std::future<RequestResult> executeAsync(const RequestConfig& config) {
-        return std::async(std::launch::async, [this, config]() {
-            return execute(config);
+        return Executor::instance().submit([this, config]() {
+            return valueOrThrow(tryExecute(config));
         });
     }
 
@@ -205,9 +225,20 @@ public:
     }
 
 private:
+    void setReading(bool reading) {
+        {
+            std::lock_guard<std::mutex> lock(read_mutex_);
+            reading_ = reading;
+        }
+        if (!reading) {
+            read_done_.notify_all();
+        }
+    }
+
     void doRead() {
         std::visit([this](auto& ws) {
             if (ws) {
+                setReading(true);
                 ws->async_read(
                     read_buffer_,
                     [this](beast::error_code ec, std::size_t bytes_transferred) {
@@ -221,19 +252,24 @@ private:
                             
                             read_buffer_.consume(bytes_transferred);
                             doRead();
-                        } else if (error_callback_) {
+                            return;
+                        }
+                        if (error_callback_) {
                             error_callback_(Error(ErrorCode::NETWORK_ERROR, ec.message()));
                         }
+                        setReading(false);
                     });
             }
         }, ws_);
     }
 
-    net::io_context ioc_;
+    net::io_context& ioc_;  // Shared I/O pool
     ssl::context ssl_ctx_;
     net::ip::tcp::resolver resolver_;
-    net::executor_work_guard<net::io_context::executor_type> work_guard_;
-    std::thread io_thread_;
+
+    std::mutex read_mutex_;
+    std::condition_variable read_done_;
+    bool reading_{false};
     
     std::variant<
         std::unique_ptr<websocket::stream<beast::tcp_stream>>,
@@ -277,7 +313,11 @@ void WebSocketHandler::connect(const RequestConfig& config) {
 }
 
 RequestResult WebSocketHandler::execute(const RequestConfig& config) {
-    return pimpl_->execute(config);
+    return valueOrThrow(pimpl_->tryExecute(config));
+}
+
+Expected<RequestResult> WebSocketHandler::tryExecute(const RequestConfig& config) noexcept {
+    return pimpl_->tryExecute(config);
 }
 
 std::future<RequestResult> WebSocketHandler::executeAsync(const RequestConfig& config) {
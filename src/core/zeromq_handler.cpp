@@ -1,8 +1,13 @@
 #include "core/zeromq_handler.hpp"
 #include "core/error.hpp"
+#include "core/executor.hpp"
 #include <thread>
 #include <future>
+#include <algorithm>
 #include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <optional>
 #include <random>
 #include <QDebug>
 #include <QObject>
@@ -10,6 +15,94 @@
 
 namespace flowdriver {
 
+namespace {
+    // Upper bound on waiting for the listener to close after unbind
+    constexpr std::chrono::milliseconds kUnbindTimeout{1000};
+
+    // Frames at least this large are handed to libzmq by reference instead of copied;
+    // below it the copy is cheaper than the reference counting
+    constexpr std::size_t kZeroCopyThreshold = 1024;
+
+    // Retry interval for ROUTER replies whose peer pipe is full, doubled up to the
+    // maximum while no peer takes anything
+    constexpr std::chrono::milliseconds kFlushRetry{1};
+    constexpr std::chrono::milliseconds kMaxFlushRetry{100};
+
+    // A peer whose pipe stays full this long loses its queued replies
+    constexpr std::chrono::seconds kPeerStallLimit{10};
+
+    // Replayed messages handed to the poll thread per task
+    constexpr std::size_t kReplayBatch = 256;
+
+    // Longest replay sleep before stopReplay() is noticed
+    constexpr std::chrono::milliseconds kReplaySlice{50};
+
+    std::string instanceEndpoint(std::string_view kind, const void* owner) {
+        return "inproc://flowdriver-" + std::string(kind) + "-" +
+               std::to_string(reinterpret_cast<std::uintptr_t>(owner));
+    }
+
+    // libzmq calls this once a zero-copy frame is sent, possibly from an I/O thread
+    void releaseFrame(void*, void* hint) {
+        delete static_cast<std::shared_ptr<const void>*>(hint);
+    }
+
+    std::size_t frameBytes(const std::vector<Frame>& frames) {
+        std::size_t bytes = 0;
+        for (const auto& frame : frames) {
+            bytes += frame.data.size();
+        }
+        return bytes;
+    }
+
+    Frame correlationFrame(uint64_t id) {
+        return Frame::fromString(std::string(reinterpret_cast<const char*>(&id), sizeof(id)));
+    }
+
+    // Correlation ID of a reply shaped [id, "", body...], the envelope is removed
+    std::optional<uint64_t> takeCorrelation(std::vector<Frame>& frames) {
+        if (frames.size() < 3 || frames[0].data.size() != sizeof(uint64_t) || !frames[1].data.empty()) {
+            return std::nullopt;
+        }
+        uint64_t id;
+        std::memcpy(&id, frames[0].data.data(), sizeof(id));
+        frames.erase(frames.begin(), frames.begin() + 2);
+        return id;
+    }
+
+    bool isBindingRole(ZeroMQHandler::Role role) {
+        return role == ZeroMQHandler::Role::PUBLISHER || role == ZeroMQHandler::Role::PULLER ||
+               role == ZeroMQHandler::Role::REPLIER || role == ZeroMQHandler::Role::ROUTER;
+    }
+
+    // tcp://host:port binds as tcp://*:port
+    std::string wildcardEndpoint(std::string endpoint) {
+        size_t pos = endpoint.find("//");
+        if (pos != std::string::npos) {
+            pos += 2;
+            size_t colonPos = endpoint.find(":", pos);
+            if (colonPos != std::string::npos) {
+                endpoint = endpoint.substr(0, pos) + "*" + endpoint.substr(colonPos);
+            }
+        }
+        return endpoint;
+    }
+
+    zmq::socket_type socketType(ZeroMQHandler::Role role) {
+        switch (role) {
+            case ZeroMQHandler::Role::REQUESTER: return zmq::socket_type::req;
+            case ZeroMQHandler::Role::REPLIER: return zmq::socket_type::rep;
+            case ZeroMQHandler::Role::PUBLISHER: return zmq::socket_type::pub;
+            case ZeroMQHandler::Role::SUBSCRIBER: return zmq::socket_type::sub;
+            case ZeroMQHandler::Role::PUSHER: return zmq::socket_type::push;
+            case ZeroMQHandler::Role::PULLER: return zmq::socket_type::pull;
+            case ZeroMQHandler::Role::DEALER: return zmq::socket_type::dealer;
+            case ZeroMQHandler::Role::ROUTER: return zmq::socket_type::router;
+        }
+        throw Error(ErrorCode::INVALID_CONFIG, "Invalid ZeroMQ role");
+    }
+}
+
 // Helper function to convert role to string for logging
 QString roleToString(ZeroMQHandler::Role role) {
     switch (role) {
@@ -33,6 +126,30 @@ ZeroMQHandler::ZeroMQHandler(QObject* parent)
     , m_pattern(Pattern::REQ_REP)
     , m_role(Role::REQUESTER)
 {
+    createWakeup();
+}
+
+void ZeroMQHandler::createWakeup() {
+    // Inproc needs both ends on the same context
+    auto wakeEndpoint = instanceEndpoint("wakeup", this);
+    m_wakeReceiver = zmq::socket_t(m_context, zmq::socket_type::pair);
+    m_wakeReceiver.set(zmq::sockopt::linger, 0);
+    m_wakeReceiver.bind(wakeEndpoint);
+    m_wakeSender = zmq::socket_t(m_context, zmq::socket_type::pair);
+    m_wakeSender.set(zmq::sockopt::linger, 0);
+    m_wakeSender.connect(wakeEndpoint);
+}
+
+// Only called with the poll thread stopped and the data socket closed
+void ZeroMQHandler::resetContext(int io_threads) {
+    // The context cannot terminate while any of its sockets is open
+    m_wakeSender.close();
+    m_wakeReceiver.close();
+    m_context.close();
+    m_context = zmq::context_t(io_threads);
+    m_ioThreads = io_threads;
+    createWakeup();
+    qDebug() << "ZMQ context recreated with" << io_threads << "I/O threads";
 }
 
 ZeroMQHandler::~ZeroMQHandler() {
@@ -49,16 +166,8 @@ void ZeroMQHandler::close() {
             m_socket->set(zmq::sockopt::linger, 0);
             
             // Unbind/disconnect based on role
-            if (m_role == Role::PUBLISHER || 
-                m_role == Role::PULLER ||
-                m_role == Role::REPLIER || 
-                m_role == Role::ROUTER) {
-                try {
-                    m_socket->unbind(m_endpoint);
-                    qDebug() << "Successfully unbound from" << QString::fromStdString(m_endpoint);
-                } catch (const zmq::error_t& e) {
-                    qDebug() << "Unbind error (expected):" << e.what();
-                }
+            if (isBindingRole(m_role)) {
+                unbindAndWait();
             } else {
                 try {
                     m_socket->disconnect(m_endpoint);
@@ -75,9 +184,15 @@ void ZeroMQHandler::close() {
         }
         m_socket.reset();
     }
+    m_peers.clear();
+    m_readyPeers.clear();
+    m_flushRetry = kFlushRetry;
+    m_capture.reset();
+    m_sockets.clear();
+    m_socketsChanged = false;
+    m_sendBlocked = false;
+    m_unsentReply.reset();
     
-    // Wait longer for the OS to release the port
-    std::this_thread::sleep_for(std::chrono::milliseconds(500));
     qDebug() << "ZMQ handler closed completely";
 }
 
@@ -110,6 +225,11 @@ void ZeroMQHandler::configure(Pattern pattern, Role role, std::string_view endpo
              << "Endpoint:" << QString::fromStdString(std::string(endpoint));
 
     close();
+    if (m_profile.io_threads != m_ioThreads) {
+        resetContext(std::max(m_profile.io_threads, 1));
+    }
+    m_receiveBatch = std::max(m_profile.receive_batch, 1);
+    m_metrics.reset();
     
     setConnectionStatus(ConnectionStatus::DISCONNECTED);
     m_pattern = pattern;
@@ -121,20 +241,8 @@ void ZeroMQHandler::configure(Pattern pattern, Role role, std::string_view endpo
         
         setCommonSocketOptions();
         
-        std::string bindEndpoint = m_endpoint;
-        if (m_role == Role::PUBLISHER || 
-            m_role == Role::PULLER ||
-            m_role == Role::REPLIER || 
-            m_role == Role::ROUTER) {
-            size_t pos = bindEndpoint.find("//");
-            if (pos != std::string::npos) {
-                pos += 2;
-                size_t colonPos = bindEndpoint.find(":", pos);
-                if (colonPos != std::string::npos) {
-                    bindEndpoint = bindEndpoint.substr(0, pos) + "*" + bindEndpoint.substr(colonPos);
-                }
-            }
-            
+        if (isBindingRole(m_role)) {
+            std::string bindEndpoint = wildcardEndpoint(m_endpoint);
             qDebug() << "Binding" << roleToString(m_role) << "socket to:" << QString::fromStdString(bindEndpoint);
             try {
                 m_socket->bind(bindEndpoint);
@@ -194,24 +302,15 @@ void ZeroMQHandler::setupDEALERROUTER() {
         m_socket->set(zmq::sockopt::linger, 0);
         m_socket->set(zmq::sockopt::rcvtimeo, m_timeout);
         m_socket->set(zmq::sockopt::sndtimeo, m_timeout);
-        
-        // For binding roles, use wildcard address
-        std::string bindEndpoint = m_endpoint;
-        size_t pos = bindEndpoint.find("//");
-        if (pos != std::string::npos) {
-            pos += 2;
-            size_t colonPos = bindEndpoint.find(":", pos);
-            if (colonPos != std::string::npos) {
-                bindEndpoint = bindEndpoint.substr(0, pos) + "*" + bindEndpoint.substr(colonPos);
-            }
-        }
+        // Report full or vanished peers instead of dropping their replies silently
+        m_socket->set(zmq::sockopt::router_mandatory, 1);
         
         // Set a default identity for ROUTER
         std::random_device rd;
         std::mt19937 gen(rd());
         m_identity = "Client";
         
-        qDebug() << "ROUTER socket created, binding to:" << QString::fromStdString(bindEndpoint);
+        qDebug() << "ROUTER socket created, binding to:" << QString::fromStdString(wildcardEndpoint(m_endpoint));
     }
 }
 
@@ -220,6 +319,9 @@ void ZeroMQHandler::setupREQREP() {
     if (m_role == Role::REQUESTER) {
         qDebug() << "Creating REQ socket";
         m_socket = std::make_unique<zmq::socket_t>(m_context, zmq::socket_type::req);
+        // A request whose reply timed out must not block the next one
+        m_socket->set(zmq::sockopt::req_relaxed, 1);
+        m_socket->set(zmq::sockopt::req_correlate, 1);
     } else if (m_role == Role::REPLIER) {
         qDebug() << "Creating REP socket";
         m_socket = std::make_unique<zmq::socket_t>(m_context, zmq::socket_type::rep);
@@ -241,8 +343,6 @@ void ZeroMQHandler::setupPUBSUB() {
         // Increase receive timeout for subscribers
         m_socket->set(zmq::sockopt::rcvtimeo, 5000);
         qDebug() << "SUB socket created";
-        // Add a small delay to ensure subscription is established
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
 }
 
@@ -250,152 +350,397 @@ void ZeroMQHandler::setupPUBSUB() {
 void ZeroMQHandler::setCommonSocketOptions() {
     if (!m_socket) return;
     
-    // Increase timeouts for REQ-REP pattern
-    if (m_pattern == Pattern::REQ_REP) {
+    if (m_profile.timeout >= 0) {
+        m_timeout = m_profile.timeout;
+    } else if (m_pattern == Pattern::REQ_REP) {
+        // Increase timeouts for REQ-REP pattern
         m_timeout = 30000;
     }
     
     // Common socket options
     m_socket->set(zmq::sockopt::rcvtimeo, m_timeout);
     m_socket->set(zmq::sockopt::sndtimeo, m_timeout);
-    m_socket->set(zmq::sockopt::immediate, 1);
-    m_socket->set(zmq::sockopt::rcvhwm, 1000);
-    m_socket->set(zmq::sockopt::sndhwm, 1000);
-    m_socket->set(zmq::sockopt::linger, 0);     // Don't wait on close
     m_socket->set(zmq::sockopt::reconnect_ivl, 100);  // Fast reconnect
+    applyProfile(*m_socket, m_profile);
     
-    qDebug() << "Common socket options set with timeout:" << m_timeout << "ms";
+    qDebug() << "Common socket options set with timeout:" << m_timeout << "ms, HWM"
+             << m_profile.send_hwm << "/" << m_profile.receive_hwm;
+}
+
+void ZeroMQHandler::applyProfile(zmq::socket_t& socket, const SocketProfile& profile) {
+    socket.set(zmq::sockopt::sndhwm, profile.send_hwm);
+    socket.set(zmq::sockopt::rcvhwm, profile.receive_hwm);
+    socket.set(zmq::sockopt::affinity, profile.affinity);
+    socket.set(zmq::sockopt::immediate, profile.immediate ? 1 : 0);
+    socket.set(zmq::sockopt::linger, profile.linger);
+    socket.set(zmq::sockopt::tcp_keepalive, profile.tcp_keepalive);
+    socket.set(zmq::sockopt::tcp_keepalive_idle, profile.tcp_keepalive_idle);
+    socket.set(zmq::sockopt::tcp_keepalive_intvl, profile.tcp_keepalive_interval);
+    socket.set(zmq::sockopt::tcp_keepalive_cnt, profile.tcp_keepalive_count);
+    socket.set(zmq::sockopt::sndbuf, profile.send_buffer);
+    socket.set(zmq::sockopt::rcvbuf, profile.receive_buffer);
+    if (profile.conflate) {
+        socket.set(zmq::sockopt::conflate, 1);
+    }
 }
 
 void ZeroMQHandler::setTimeout(int timeout) {
     m_timeout = timeout;
-    if (m_socket) {
-        m_socket->set(zmq::sockopt::rcvtimeo, m_timeout);
-        m_socket->set(zmq::sockopt::sndtimeo, m_timeout);
-    }
+    invoke([timeout](zmq::socket_t& socket) {
+        socket.set(zmq::sockopt::rcvtimeo, timeout);
+        socket.set(zmq::sockopt::sndtimeo, timeout);
+    });
 }
 
 void ZeroMQHandler::subscribe(const std::vector<std::string>& topics) {
-    if (!m_socket || m_role != Role::SUBSCRIBER) {
+    if (m_role != Role::SUBSCRIBER) {
         return;
     }
     
-    if (topics.empty()) {
-        m_socket->set(zmq::sockopt::subscribe, "");
-    } else {
-        for (const auto& topic : topics) {
-            m_socket->set(zmq::sockopt::subscribe, topic);
+    invoke([topics](zmq::socket_t& socket) {
+        if (topics.empty()) {
+            socket.set(zmq::sockopt::subscribe, "");
+        } else {
+            for (const auto& topic : topics) {
+                socket.set(zmq::sockopt::subscribe, topic);
+            }
         }
-    }
+    });
+}
+
+void ZeroMQHandler::setPipeline(PipelineOptions options) {
+    options.window = std::max<std::size_t>(options.window, 1);
+    post([this, options](zmq::socket_t* socket) {
+        m_pipeline = options;
+        if (socket) {
+            sendBacklog(*socket);
+        }
+    });
+}
+
+std::vector<ZeroMQHandler::PeerStats> ZeroMQHandler::routerPeers() {
+    std::vector<PeerStats> peers;
+    invoke([this, &peers](zmq::socket_t&) {
+        for (const auto& [identity, peer] : m_peers) {
+            auto stats = peer.stats;
+            stats.queued = peer.outbox.size();
+            peers.push_back(std::move(stats));
+        }
+    });
+    return peers;
 }
 
 RequestResult ZeroMQHandler::execute(const RequestConfig& config) {
-    if (!m_socket) {
-        throw Error(ErrorCode::ZMQ_ERROR, "Socket not initialized");
+    return valueOrThrow(tryExecute(config));
+}
+
+Expected<RequestResult> ZeroMQHandler::tryExecute(const RequestConfig& config) noexcept {
+    // Prevent SUBSCRIBER from sending messages
+    if (m_role == Role::SUBSCRIBER) {
+        return makeError(ErrorCode::ZMQ_ERROR, "Subscribers cannot send messages");
     }
-    
+
+    // A plain body is copied once into a frame, multipart requests share their frames
+    bool multipart = !config.frames.empty();
+    auto frames = multipart ? config.frames : std::vector<Frame>{Frame::fromString(config.body)};
+    if (!multipart) {
+        qDebug() << "Executing ZMQ request with body:" << QString::fromStdString(config.body);
+    }
+
+    // The poll thread owns the socket; any number of callers may queue sends
+    std::promise<Expected<RequestResult>> reply;
+    auto result = reply.get_future();
+    post([this, frames = std::move(frames), multipart, reply = std::move(reply)](zmq::socket_t* socket) mutable {
+        if (!socket) {
+            reply.set_value(makeError(ErrorCode::ZMQ_ERROR, "Socket not initialized"));
+            return;
+        }
+        sendRequest(*socket, std::move(frames), multipart, std::move(reply));
+    });
     try {
-        // Prevent SUBSCRIBER from sending messages
-        if (m_role == Role::SUBSCRIBER) {
-            throw Error(ErrorCode::ZMQ_ERROR, "Subscribers cannot send messages");
+        return result.get();
+    } catch (const std::future_error&) {
+        // The task failed before it could hand the reply on
+        return makeError(ErrorCode::ZMQ_ERROR, "Request was dropped by the socket thread");
+    }
+}
+
+// Runs on the poll thread
+void ZeroMQHandler::sendRequest(zmq::socket_t& socket, std::vector<Frame> frames, bool multipart,
+                                std::promise<Expected<RequestResult>> reply) {
+    // Sent in order without blocking; a request that cannot go out before its deadline fails
+    if (m_role != Role::ROUTER) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(m_timeout);
+        m_backlog.push_back({std::move(frames), multipart, std::move(reply), deadline});
+        sendBacklog(socket);
+        return;
+    }
+
+    if (m_identity.empty()) {
+        m_identity = "Game"; // Default identity if none is set
+    }
+    std::vector<Frame> message{Frame::fromString(m_identity)};
+    message.insert(message.end(), frames.begin(), frames.end());
+
+    // Sent right away unless earlier replies to the peer are still queued; flushPeers counts queued ones
+    auto peer = m_peers.find(m_identity);
+    if (peer != m_peers.end() && !peer->second.outbox.empty()) {
+        queueToPeer(m_identity, std::move(message));
+    } else if (sendFrames(socket, message, false, ZMQ_DONTWAIT)) {
+        m_metrics.countSent(frameBytes(message));
+    } else if (zmq_errno() == EAGAIN) {
+        queueToPeer(m_identity, std::move(message));
+    } else {
+        reply.set_value(lastZmqError("Failed to send to " + m_identity));
+        return;
+    }
+
+    if (!multipart) {
+        emit messageReceived(displayText(frames));
+    }
+    reply.set_value(createResult(std::move(frames), !multipart));
+}
+
+void ZeroMQHandler::sendBacklog(zmq::socket_t& socket) {
+    // Only requests expecting a reply take a window slot; REQ cannot have more than one outstanding
+    bool awaitsReply = m_role == Role::REQUESTER || m_role == Role::DEALER;
+    auto window = m_role == Role::REQUESTER ? std::size_t{1} : m_pipeline.window;
+    bool correlate = m_role == Role::DEALER && m_pipeline.correlate;
+
+    m_sendBlocked = false;
+    while (!m_backlog.empty() && (!awaitsReply || m_pendingReplies.size() < window)) {
+        auto id = m_nextCorrelation;
+        std::vector<Frame> envelope;
+        if (correlate) {
+            envelope = {correlationFrame(id), Frame{}};
         }
 
-        qDebug() << "Executing ZMQ request with body:" << QString::fromStdString(config.body);
-        
-        if (m_role == Role::PUBLISHER) {
-            zmq::message_t message(config.body.data(), config.body.size());
-            if (!m_socket->send(message, zmq::send_flags::none)) {
-                throw Error(ErrorCode::ZMQ_ERROR, "Failed to publish message");
-            }
-            emit messageReceived(QString::fromStdString(config.body));
-            return createResult(config.body);
+        // The poll thread never waits on a full pipe or a missing peer; libzmq
+        // accepts the rest of a message once its first part is queued
+        const auto& frames = m_backlog.front().frames;
+        bool sent = correlate ? sendFrames(socket, envelope, true, ZMQ_DONTWAIT) &&
+                                    sendFrames(socket, frames, false, ZMQ_DONTWAIT)
+                              : sendFrames(socket, frames, false, ZMQ_DONTWAIT);
+        if (!sent && zmq_errno() == EAGAIN) {
+            // Retried once the socket polls writable
+            m_sendBlocked = true;
+            return;
         }
-        
+
+        auto request = std::move(m_backlog.front());
+        m_backlog.pop_front();
+        if (!sent) {
+            request.reply.set_value(lastZmqError(m_role == Role::PUBLISHER ? "Failed to publish message"
+                                                                           : "Failed to send message"));
+            continue;
+        }
+        ++m_nextCorrelation;
+        m_metrics.countSent(frameBytes(request.frames));
+        if (!request.multipart) {
+            emit messageReceived(displayText(request.frames));
+        }
+        if (!awaitsReply) {
+            request.reply.set_value(createResult(std::move(request.frames), !request.multipart));
+            continue;
+        }
+
+        // REQ must get its reply; a DEALER reply is optional and the request is echoed without one
+        PendingReply pending;
+        pending.reply = std::move(request.reply);
+        pending.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(m_timeout);
+        pending.multipart = request.multipart;
         if (m_role == Role::DEALER) {
-            // For DEALER, just send the message directly
-            zmq::message_t message(config.body.data(), config.body.size());
-            auto send_result = m_socket->send(message, zmq::send_flags::none);
-            
-            if (!send_result) {
-                qDebug() << "Failed to send DEALER message";
-                throw Error(ErrorCode::ZMQ_ERROR, "Failed to send message");
-            }
-            
-            qDebug() << "DEALER message sent successfully";
-            emit messageReceived(QString::fromStdString(config.body));
-            
-            // Wait for response from ROUTER
-            zmq::message_t response;
-            auto recv_result = m_socket->recv(response, zmq::recv_flags::none);
-            
-            if (recv_result) {
-                std::string response_str(static_cast<char*>(response.data()), response.size());
-                qDebug() << "DEALER received response:" << QString::fromStdString(response_str);
-                return createResult(response_str);
+            pending.on_timeout = std::move(request.frames);
+        }
+        m_pendingReplies.emplace(id, std::move(pending));
+    }
+}
+
+bool ZeroMQHandler::completeReply(std::vector<Frame>& frames) {
+    // Replies without a correlation envelope answer the oldest request
+    auto pending = m_pendingReplies.begin();
+    if (m_role == Role::DEALER && m_pipeline.correlate) {
+        if (auto id = takeCorrelation(frames)) {
+            pending = m_pendingReplies.find(*id);
+            if (pending == m_pendingReplies.end()) {
+                qDebug() << "Dropping reply to expired request" << *id;
+                return true;
             }
-            
-            return createResult(config.body);
         }
-        
-        if (m_role == Role::ROUTER) {
-            // For ROUTER, we need to send identity frame first
-            if (m_identity.empty()) {
-                m_identity = "Game"; // Default identity if none is set
+    }
+    if (pending == m_pendingReplies.end()) {
+        return false;
+    }
+
+    auto entry = std::move(pending->second);
+    m_pendingReplies.erase(pending);
+    entry.reply.set_value(createResult(std::move(frames), !entry.multipart));
+    return true;
+}
+
+void ZeroMQHandler::expireReplies(bool closing) {
+    auto now = std::chrono::steady_clock::now();
+    while (!m_pendingReplies.empty() && (closing || m_pendingReplies.begin()->second.deadline <= now)) {
+        auto pending = std::move(m_pendingReplies.begin()->second);
+        m_pendingReplies.erase(m_pendingReplies.begin());
+        if (closing) {
+            pending.reply.set_value(makeError(ErrorCode::ZMQ_ERROR, "Socket closed before the reply arrived"));
+        } else if (pending.on_timeout) {
+            pending.reply.set_value(createResult(std::move(*pending.on_timeout), !pending.multipart));
+        } else {
+            pending.reply.set_value(makeError(ErrorCode::TIMEOUT, "No reply received"));
+        }
+    }
+
+    if (closing) {
+        for (auto& request : m_backlog) {
+            request.reply.set_value(makeError(ErrorCode::ZMQ_ERROR, "Socket closed before the request was sent"));
+        }
+        m_backlog.clear();
+        return;
+    }
+
+    // Requests still waiting for a peer or a window slot
+    while (!m_backlog.empty() && m_backlog.front().deadline <= now) {
+        m_backlog.front().reply.set_value(makeError(ErrorCode::TIMEOUT, "Request could not be sent"));
+        m_backlog.pop_front();
+    }
+}
+
+void ZeroMQHandler::queueToPeer(const std::string& identity, std::vector<Frame> message) {
+    auto& peer = m_peers[identity];
+    peer.stats.identity = identity;
+    if (peer.outbox.empty()) {
+        m_readyPeers.push_back(identity);
+    }
+    peer.outbox.push_back(std::move(message));
+}
+
+// One message per peer per turn, so a busy client cannot starve the others
+void ZeroMQHandler::flushPeers(zmq::socket_t& socket) {
+    auto now = std::chrono::steady_clock::now();
+    bool sentAny = false;
+    bool progress = true;
+    while (progress && !m_readyPeers.empty()) {
+        progress = false;
+        for (auto turns = m_readyPeers.size(); turns > 0; --turns) {
+            auto identity = std::move(m_readyPeers.front());
+            m_readyPeers.pop_front();
+            auto found = m_peers.find(identity);
+            if (found == m_peers.end() || found->second.outbox.empty()) {
+                continue;
             }
-            
-            zmq::message_t identity(m_identity.data(), m_identity.size());
-            if (!m_socket->send(identity, zmq::send_flags::sndmore)) {
-                throw Error(ErrorCode::ZMQ_ERROR, "Failed to send identity frame");
+
+            auto& peer = found->second;
+            const auto& message = peer.outbox.front();
+            if (!sendFrames(socket, message, false, ZMQ_DONTWAIT)) {
+                if (zmq_errno() != EAGAIN) {
+                    qDebug() << "ROUTER dropping" << peer.outbox.size() << "replies to"
+                             << QString::fromStdString(identity) << ":" << zmq_strerror(zmq_errno());
+                    m_peers.erase(found);
+                } else if (!peer.blockedSince) {
+                    peer.blockedSince = now;
+                    m_readyPeers.push_back(std::move(identity));
+                } else if (now - *peer.blockedSince >= kPeerStallLimit) {
+                    // A client that stopped reading must not keep the poll loop retrying forever
+                    qDebug() << "ROUTER dropping" << peer.outbox.size() << "replies to"
+                             << QString::fromStdString(identity) << ": pipe full for"
+                             << kPeerStallLimit.count() << "s";
+                    peer.stats.dropped += peer.outbox.size();
+                    peer.outbox.clear();
+                    peer.blockedSince.reset();
+                } else {
+                    // Pipe full, the peer keeps its turn for the next flush
+                    m_readyPeers.push_back(std::move(identity));
+                }
+                continue;
             }
-            
-            // Then send the actual message
-            zmq::message_t message(config.body.data(), config.body.size());
-            if (!m_socket->send(message, zmq::send_flags::none)) {
-                throw Error(ErrorCode::ZMQ_ERROR, "Failed to send message");
+
+            m_metrics.countSent(frameBytes(message));
+            peer.stats.messagesSent++;
+            peer.stats.bytesSent += frameBytes(message) - message.front().data.size();
+            peer.outbox.pop_front();
+            peer.blockedSince.reset();
+            if (!peer.outbox.empty()) {
+                m_readyPeers.push_back(std::move(identity));
             }
-            
-            qDebug() << "ROUTER message sent successfully to" << QString::fromStdString(m_identity);
-            emit messageReceived(QString::fromStdString(config.body));
-            return createResult(config.body);
+            progress = true;
+            sentAny = true;
         }
-        
-        // Send the message for other patterns
-        zmq::message_t request(config.body.data(), config.body.size());
-        auto send_result = m_socket->send(request, zmq::send_flags::none);
-        
-        if (!send_result) {
-            qDebug() << "Failed to send message";
-            throw Error(ErrorCode::ZMQ_ERROR, "Failed to send message");
+    }
+
+    // Back off while every remaining peer is stuck instead of waking up each millisecond
+    m_flushRetry = sentAny ? kFlushRetry : std::min(m_flushRetry * 2, kMaxFlushRetry);
+}
+
+void ZeroMQHandler::post(SocketTask task) {
+    {
+        std::lock_guard<std::mutex> lock(m_taskMutex);
+        if (m_running) {
+            m_tasks.push_back(std::move(task));
+            // One wakeup per batch, later tasks ride along until the poll thread drains
+            if (!m_wakePending) {
+                m_wakePending = true;
+                wake();
+            }
+            return;
         }
-        
-        qDebug() << "Message sent successfully";
-        emit messageReceived(QString::fromStdString(config.body));
-        
-        // For REQ-REP pattern, wait for response (only for REQUESTER)
-        if (m_pattern == Pattern::REQ_REP && m_role == Role::REQUESTER) {
-            zmq::message_t reply;
-            auto recv_result = m_socket->recv(reply);
-            
-            if (recv_result) {
-                std::string reply_str(static_cast<char*>(reply.data()), reply.size());
-                qDebug() << "Received reply:" << QString::fromStdString(reply_str);
-                return createResult(reply_str);
-            } else {
-                throw Error(ErrorCode::TIMEOUT, "No reply received");
+    }
+    task(nullptr);
+}
+
+void ZeroMQHandler::invoke(std::move_only_function<void(zmq::socket_t&)> fn) {
+    bool running;
+    {
+        std::lock_guard<std::mutex> lock(m_taskMutex);
+        running = m_running;
+    }
+    if (!running) {
+        // No poll thread, the caller is the only user of the socket
+        if (m_socket) {
+            fn(*m_socket);
+        }
+        return;
+    }
+
+    std::promise<void> done;
+    auto finished = done.get_future();
+    post([fn = std::move(fn), done = std::move(done)](zmq::socket_t* socket) mutable {
+        try {
+            if (socket) {
+                fn(*socket);
             }
+        } catch (...) {
+            // Thrown again on the caller's side
+            done.set_exception(std::current_exception());
+            return;
+        }
+        done.set_value();
+    });
+    finished.get();
+}
+
+void ZeroMQHandler::runTasks(zmq::socket_t* socket) {
+    std::deque<SocketTask> batch;
+    {
+        std::lock_guard<std::mutex> lock(m_taskMutex);
+        batch.swap(m_tasks);
+        m_wakePending = false;
+    }
+    // A failing task must not unwind through the batch and break the promises of the others
+    for (auto& task : batch) {
+        try {
+            task(socket);
+        } catch (const std::exception& e) {
+            qDebug() << "ZMQ socket task failed:" << e.what();
+            emit errorOccurred(QString::fromStdString(e.what()));
         }
-        
-        return createResult(config.body);
-        
-    } catch (const zmq::error_t& e) {
-        qDebug() << "ZMQ error during execute:" << e.what();
-        throw Error(ErrorCode::ZMQ_ERROR, e.what());
     }
 }
 
 std::future<RequestResult> ZeroMQHandler::executeAsync(const RequestConfig& config) {
-    return std::async(std::launch::async, [this, config]() {
-        return execute(config);
+    return Executor::instance().submit([this, config]() {
+        return valueOrThrow(tryExecute(config));
     });
 }
 
@@ -411,189 +756,663 @@ void ZeroMQHandler::startPolling() {
         return;
     }
     
-    m_running = true;
-    m_pollThread = std::make_unique<std::thread>([this]() {
-        qDebug() << "Poll thread started for role:" << static_cast<int>(m_role);
-        
-        while (m_running) {
-            try {
-                if (!m_socket) break;
+    {
+        std::lock_guard<std::mutex> lock(m_taskMutex);
+        m_running = true;
+    }
+    m_pollThread = std::make_unique<std::thread>([this]() { pollLoop(); });
+}
+
+void ZeroMQHandler::pollLoop() {
+    qDebug() << "Poll thread started for role:" << static_cast<int>(m_role);
 
-                zmq::pollitem_t items[] = {
+    // Wakeup, the configured socket, then the added ones in m_sockets order
+    std::vector<zmq::pollitem_t> items;
+    m_socketsChanged = true;
+
+    while (true) {
+        try {
+            if (m_socketsChanged) {
+                items = {
+                    { m_wakeReceiver.handle(), 0, ZMQ_POLLIN, 0 },
                     { m_socket->handle(), 0, ZMQ_POLLIN, 0 }
                 };
+                for (const auto& named : m_sockets) {
+                    items.push_back({ named->socket.handle(), 0, ZMQ_POLLIN, 0 });
+                }
+                m_socketsChanged = false;
+            }
 
-                if (zmq::poll(items, 1, std::chrono::duration<long long, std::milli>(100)) > 0) {
-                    if (items[0].revents & ZMQ_POLLIN) {
-                        switch (m_pattern) {
-                            case Pattern::REQ_REP:
-                                handleREQREPMessage();
-                                break;
-                            case Pattern::PUB_SUB:
-                                handlePUBSUBMessage();
-                                break;
-                            case Pattern::PUSH_PULL:
-                                handlePUSHPULLMessage();
-                                break;
-                            case Pattern::DEALER_ROUTER:
-                                handleDEALERROUTERMessage();
-                                break;
-                        }
-                    }
+            // Sleeps until traffic, queued work, room for a held back send or the next deadline
+            items[1].events = ZMQ_POLLIN | ((m_sendBlocked || m_unsentReply) ? ZMQ_POLLOUT : 0);
+            for (std::size_t i = 0; i < m_sockets.size(); ++i) {
+                items[i + 2].events = m_sockets[i]->unsentReply ? ZMQ_POLLOUT : ZMQ_POLLIN;
+            }
+            std::optional<std::chrono::steady_clock::time_point> deadline;
+            if (!m_pendingReplies.empty()) {
+                deadline = m_pendingReplies.begin()->second.deadline;
+            }
+            if (!m_backlog.empty() && (!deadline || m_backlog.front().deadline < *deadline)) {
+                deadline = m_backlog.front().deadline;
+            }
+            auto timeout = std::chrono::milliseconds(-1);
+            if (deadline) {
+                timeout = std::max(std::chrono::milliseconds(0), std::chrono::ceil<std::chrono::milliseconds>(
+                                                                     *deadline - std::chrono::steady_clock::now()));
+            }
+            if (!m_readyPeers.empty() && (timeout.count() < 0 || timeout > m_flushRetry)) {
+                timeout = m_flushRetry;
+            }
+            if (m_capture && m_capture->buffered() && (timeout.count() < 0 || timeout > CaptureWriter::kFlushInterval)) {
+                timeout = CaptureWriter::kFlushInterval;
+            }
+            zmq::poll(items.data(), items.size(), timeout);
+
+            if (items[0].revents & ZMQ_POLLIN) {
+                zmq::message_t wakeup;
+                while (m_wakeReceiver.recv(wakeup, zmq::recv_flags::dontwait)) {
                 }
-            } catch (const zmq::error_t& e) {
-                qDebug() << "Error in poll thread:" << e.what();
-                emit errorOccurred(QString::fromStdString(e.what()));
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                if (!m_running) {
+                    break;
+                }
+                runTasks(m_socket.get());
+            }
+
+            if (items[1].revents & ZMQ_POLLIN) {
+                switch (m_pattern) {
+                    case Pattern::REQ_REP:
+                        handleREQREPMessage();
+                        break;
+                    case Pattern::PUB_SUB:
+                        handlePUBSUBMessage();
+                        break;
+                    case Pattern::PUSH_PULL:
+                        handlePUSHPULLMessage();
+                        break;
+                    case Pattern::DEALER_ROUTER:
+                        handleDEALERROUTERMessage();
+                        break;
+                }
+            }
+
+            // Items are stale if a task just added or removed a socket
+            for (std::size_t i = 0; !m_socketsChanged && i < m_sockets.size(); ++i) {
+                if (items[i + 2].revents & (ZMQ_POLLIN | ZMQ_POLLOUT)) {
+                    handleNamedSocket(*m_sockets[i]);
+                }
+            }
+
+            expireReplies(false);
+            sendUnsentReply(*m_socket);
+            sendBacklog(*m_socket);
+            if (!m_readyPeers.empty()) {
+                flushPeers(*m_socket);
+            }
+            flushCapture();
+        } catch (const zmq::error_t& e) {
+            if (e.num() == ETERM) {
+                break;
             }
+            qDebug() << "Error in poll thread:" << e.what();
+            emit errorOccurred(QString::fromStdString(e.what()));
+        } catch (const std::exception& e) {
+            // Anything else would end the thread through std::terminate
+            qDebug() << "Error in poll thread:" << e.what();
+            emit errorOccurred(QString::fromStdString(e.what()));
         }
-    });
+    }
+
+    // Nothing queued or awaiting a reply may be left hanging
+    expireReplies(true);
+    runTasks(nullptr);
 }
 
-void ZeroMQHandler::handleREQREPMessage() {
-    if (m_role == Role::REPLIER) {
-        zmq::message_t message;
-        if (m_socket->recv(message)) {
-            std::string msg_str(static_cast<char*>(message.data()), message.size());
-            emit messageReceived(QString::fromStdString(msg_str));
-            
-            // Send reply
-            std::string reply = "Reply to: " + msg_str;
-            zmq::message_t reply_msg(reply.data(), reply.size());
-            if (m_socket->send(reply_msg, zmq::send_flags::none)) {
-                qDebug() << "REPLIER sent reply";
-            }
+void ZeroMQHandler::wake() {
+    std::lock_guard<std::mutex> lock(m_wakeMutex);
+    // Content is irrelevant; if the pipe is full a wakeup is already pending
+    zmq_send(m_wakeSender.handle(), "", 0, ZMQ_DONTWAIT);
+}
+
+void ZeroMQHandler::unbindAndWait() {
+    auto bound = m_socket->get(zmq::sockopt::last_endpoint);
+    if (bound.empty()) {
+        return;
+    }
+
+    // Inproc unbinds synchronously, network listeners close on an I/O thread
+    std::optional<zmq::socket_t> monitor;
+    auto monitorEndpoint = instanceEndpoint("monitor", this);
+    if (!bound.starts_with("inproc://") &&
+        zmq_socket_monitor(m_socket->handle(), monitorEndpoint.c_str(), ZMQ_EVENT_CLOSED) == 0) {
+        monitor.emplace(m_context, zmq::socket_type::pair);
+        monitor->connect(monitorEndpoint);
+    }
+
+    try {
+        // The resolved endpoint, unbinding the configured one fails for wildcard binds
+        m_socket->unbind(bound);
+        qDebug() << "Successfully unbound from" << QString::fromStdString(bound);
+    } catch (const zmq::error_t& e) {
+        qDebug() << "Unbind error:" << e.what();
+    }
+
+    if (monitor) {
+        // ZMQ_EVENT_CLOSED means the port is free for the next bind
+        zmq::pollitem_t item{ monitor->handle(), 0, ZMQ_POLLIN, 0 };
+        if (zmq::poll(&item, 1, kUnbindTimeout) == 0) {
+            qDebug() << "Listener did not report closing within" << kUnbindTimeout.count() << "ms";
         }
+        zmq_socket_monitor(m_socket->handle(), nullptr, 0);
+        monitor->set(zmq::sockopt::linger, 0);
+    }
+}
+
+void ZeroMQHandler::handleREQREPMessage() {
+    std::vector<Frame> frames;
+    if (!receiveFrames(*m_socket, frames)) {
+        return;
+    }
+    m_metrics.countReceived(frameBytes(frames));
+
+    if (m_role == Role::REQUESTER) {
+        qDebug() << "Received reply:" << displayText(frames);
+        completeReply(frames);
+    } else if (m_role == Role::REPLIER) {
+        emit messageReceived(displayText(frames));
+
+        // Leading parts go back untouched, only the last one is answered
+        std::string reply = "Reply to: " + std::string(frames.back().data);
+        frames.back() = Frame::fromString(std::move(reply));
+        m_unsentReply = std::move(frames);
+        sendUnsentReply(*m_socket);
+    }
+}
+
+// REP cannot receive again before its reply is out, so a reply to a full pipe waits for POLLOUT
+void ZeroMQHandler::sendUnsentReply(zmq::socket_t& socket) {
+    if (!m_unsentReply) {
+        return;
+    }
+    if (sendFrames(socket, *m_unsentReply, false, ZMQ_DONTWAIT)) {
+        m_metrics.countSent(frameBytes(*m_unsentReply));
+        qDebug() << "REPLIER sent reply";
+    } else if (zmq_errno() == EAGAIN) {
+        return;
     }
+    m_unsentReply.reset();
 }
 
 void ZeroMQHandler::handlePUBSUBMessage() {
     if (m_role == Role::SUBSCRIBER) {
-        zmq::message_t message;
-        if (m_socket->recv(message)) {
-            std::string msg_str(static_cast<char*>(message.data()), message.size());
-            QString qmsg = QString::fromStdString(msg_str);
-            
-            qDebug() << "SUB about to emit message:" << qmsg;
-            emit messageReceived(qmsg);
-            qDebug() << "SUB emitted message:" << qmsg;
+        std::vector<Frame> frames;
+        for (int i = 0; i < m_receiveBatch && receiveFrames(*m_socket, frames, ZMQ_DONTWAIT); ++i) {
+            m_metrics.countReceived(frameBytes(frames));
+            captureFrames(frames, false);
+            emit messageReceived(displayText(frames));
         }
     }
 }
 
 void ZeroMQHandler::handlePUSHPULLMessage() {
     if (m_role == Role::PULLER) {
-        zmq::message_t message;
-        if (m_socket->recv(message)) {
-            processIncomingMessage(zmq::message_t(), message);
+        std::vector<Frame> frames;
+        for (int i = 0; i < m_receiveBatch && receiveFrames(*m_socket, frames, ZMQ_DONTWAIT); ++i) {
+            captureFrames(frames, false);
+            processIncomingMessage(frames);
         }
     }
 }
 
 void ZeroMQHandler::handleDEALERROUTERMessage() {
-    std::vector<zmq::message_t> messages;
-    bool more = true;
-    
+    std::vector<Frame> frames;
+    for (int i = 0; i < m_receiveBatch && receiveFrames(*m_socket, frames, ZMQ_DONTWAIT); ++i) {
+        m_metrics.countReceived(frameBytes(frames));
+
+        if (m_role == Role::ROUTER) {
+            handleRouterMessage(std::move(frames));
+        } else if (m_role == Role::DEALER && !completeReply(frames)) {
+            emit messageReceived(displayText(frames));
+        }
+    }
+
+    // Replies freed window slots, or produced replies of their own
+    if (m_role == Role::ROUTER) {
+        flushPeers(*m_socket);
+    } else {
+        sendBacklog(*m_socket);
+    }
+}
+
+void ZeroMQHandler::handleRouterMessage(std::vector<Frame> frames) {
+    // First frame is identity for ROUTER
+    if (frames.size() < 2) {
+        return;
+    }
+    captureFrames(frames, true);
+    std::string identity(frames.front().data);
+    auto& peer = m_peers[identity];
+    peer.stats.identity = identity;
+    peer.stats.messagesReceived++;
+    peer.stats.bytesReceived += frameBytes(frames) - frames.front().data.size();
+
+    // Store the client identity for sending responses back
+    m_identity = identity;
+
+    // Frames up to an empty delimiter are the envelope, they go back unchanged
+    auto body = frames.begin() + 1;
+    auto delimiter = std::find_if(body, frames.end(), [](const Frame& frame) { return frame.data.empty(); });
+    if (delimiter != frames.end() && delimiter + 1 != frames.end()) {
+        body = delimiter + 1;
+    }
+    std::vector<Frame> parts(body, frames.end());
+    emit messageReceived(displayText(parts));
+
+    // Replies are queued per peer and drained fairly once the batch is read
+    std::vector<Frame> response(frames.begin(), body);
+    response.push_back(Frame::fromString("Response to: " + std::string(parts.back().data)));
+    queueToPeer(identity, std::move(response));
+}
+
+void ZeroMQHandler::captureFrames(const std::vector<Frame>& frames, bool routed) {
+    if (!m_capture) {
+        return;
+    }
     try {
-        while (more) {
-            zmq::message_t message;
-            auto recv_result = m_socket->recv(message, zmq::recv_flags::dontwait);
-            if (recv_result) {
-                messages.push_back(std::move(message));
-                more = m_socket->get(zmq::sockopt::rcvmore);
-            } else {
-                break;
+        auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch());
+        m_capture->append(now.count(), frames, routed);
+    } catch (const Error& e) {
+        // A full disk must not take the receive loop down
+        m_capture.reset();
+        emit errorOccurred(QString("Capture stopped: ") + e.what());
+    }
+}
+
+void ZeroMQHandler::flushCapture() {
+    if (!m_capture) {
+        return;
+    }
+    try {
+        // Records received before the socket went quiet reach the file too
+        m_capture->flushIfDue();
+    } catch (const Error& e) {
+        m_capture.reset();
+        emit errorOccurred(QString("Capture stopped: ") + e.what());
+    }
+}
+
+void ZeroMQHandler::startCapture(const std::string& path) {
+    if (m_role != Role::SUBSCRIBER && m_role != Role::PULLER && m_role != Role::ROUTER) {
+        throw Error(ErrorCode::INVALID_STATE, "Capture needs a SUBSCRIBER, PULLER or ROUTER socket");
+    }
+
+    // Opened here so the caller sees the error
+    auto writer = std::make_unique<CaptureWriter>(path);
+    std::promise<void> done;
+    auto started = done.get_future();
+    post([this, writer = std::move(writer), done = std::move(done)](zmq::socket_t*) mutable {
+        m_capture = std::move(writer);
+        done.set_value();
+    });
+    started.wait();
+}
+
+void ZeroMQHandler::stopCapture() {
+    std::promise<void> done;
+    auto stopped = done.get_future();
+    post([this, done = std::move(done)](zmq::socket_t*) mutable {
+        if (m_capture) {
+            qDebug() << "ZeroMQ capture stopped after" << m_capture->records() << "records";
+        }
+        m_capture.reset();
+        done.set_value();
+    });
+    stopped.wait();
+}
+
+ZeroMQHandler::ReplayStats ZeroMQHandler::replay(const std::string& path, const ReplayOptions& options) {
+    if (m_role != Role::PUBLISHER && m_role != Role::PUSHER && m_role != Role::DEALER) {
+        throw Error(ErrorCode::INVALID_STATE, "Replay needs a PUBLISHER, PUSHER or DEALER socket");
+    }
+    if (options.pacing == ReplayPacing::SCALED && options.speed <= 0.0) {
+        throw Error(ErrorCode::INVALID_CONFIG, "Replay speed must be greater than 0");
+    }
+    if (!m_socket) {
+        throw Error(ErrorCode::INVALID_STATE, "Socket not initialized");
+    }
+
+    CaptureReader reader(path);
+    ReplayStats stats;
+    std::vector<std::vector<Frame>> batch;
+
+    // Sleeps in slices so stopReplay() ends long gaps too
+    auto sleepUntil = [this](std::chrono::steady_clock::time_point due) {
+        while (m_replaying) {
+            auto now = std::chrono::steady_clock::now();
+            if (now >= due) {
+                return;
             }
+            std::this_thread::sleep_for(std::min<std::chrono::nanoseconds>(due - now, kReplaySlice));
         }
-        
-        if (messages.empty()) return;
-        
-        if (m_role == Role::ROUTER) {
-            // First frame is identity for ROUTER
-            if (messages.size() >= 2) {
-                std::string identityStr(static_cast<const char*>(messages[0].data()), messages[0].size());
-                std::string messageStr(static_cast<const char*>(messages[1].data()), messages[1].size());
-                
-                qDebug() << "ROUTER received message from client:" << QString::fromStdString(identityStr)
-                         << "content:" << QString::fromStdString(messageStr);
-                
-                // Store the client identity for sending responses back
-                m_identity = identityStr;
-                
-                // Process the message content
-                emit messageReceived(QString::fromStdString(messageStr));
-                
-                // Send an immediate response back to the client
-                if (!m_identity.empty()) {
-                    std::string responseMsg = "Response to: " + messageStr;
-                    zmq::message_t identity(m_identity.data(), m_identity.size());
-                    zmq::message_t response(responseMsg.data(), responseMsg.size());
-                    
-                    m_socket->send(identity, zmq::send_flags::sndmore);
-                    m_socket->send(response, zmq::send_flags::none);
-                    
-                    qDebug() << "ROUTER sent response to" << QString::fromStdString(m_identity)
-                             << ":" << QString::fromStdString(responseMsg);
+    };
+
+    // Due messages go to the poll thread together, frames still point into the mapping.
+    // A full socket hands the rest back here, the poll thread never waits for room.
+    auto sendBatch = [this, &batch, &stats, &sleepUntil]() {
+        std::size_t next = 0;
+        while (next < batch.size() && m_replaying) {
+            invoke([this, &batch, &stats, &next](zmq::socket_t& socket) {
+                for (; next < batch.size(); ++next) {
+                    if (sendFrames(socket, batch[next], false, ZMQ_DONTWAIT)) {
+                        auto bytes = frameBytes(batch[next]);
+                        ++stats.messages;
+                        stats.bytes += bytes;
+                        m_metrics.countSent(bytes);
+                    } else if (zmq_errno() == EAGAIN) {
+                        return;
+                    } else {
+                        ++stats.failed;
+                    }
+                }
+            });
+            if (next < batch.size()) {
+                sleepUntil(std::chrono::steady_clock::now() + kFlushRetry);
+            }
+        }
+        batch.clear();
+    };
+
+    m_replaying = true;
+    auto started = std::chrono::steady_clock::now();
+    std::optional<std::int64_t> first;
+    while (m_replaying) {
+        auto record = reader.next();
+        if (!record) {
+            break;
+        }
+
+        if (options.pacing != ReplayPacing::MAX) {
+            if (!first) {
+                first = record->timestamp_ns;
+            }
+            auto offset = std::chrono::nanoseconds(record->timestamp_ns - *first);
+            if (options.pacing == ReplayPacing::SCALED) {
+                offset = std::chrono::duration_cast<std::chrono::nanoseconds>(offset / options.speed);
+            }
+            auto due = started + offset;
+            if (due > std::chrono::steady_clock::now()) {
+                // Whatever is already due goes out before sleeping
+                sendBatch();
+                sleepUntil(due);
+                if (!m_replaying) {
+                    break;
                 }
             }
-        } else if (m_role == Role::DEALER) {
-            if (!messages.empty()) {
-                std::string messageStr(static_cast<const char*>(messages[0].data()), messages[0].size());
-                qDebug() << "DEALER received message:" << QString::fromStdString(messageStr);
-                emit messageReceived(QString::fromStdString(messageStr));
+            stats.max_lag = std::max(stats.max_lag, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                        std::chrono::steady_clock::now() - due));
+        }
+
+        if (record->routed && !record->frames.empty()) {
+            record->frames.erase(record->frames.begin());
+        }
+        batch.push_back(std::move(record->frames));
+        if (batch.size() >= kReplayBatch) {
+            sendBatch();
+        }
+    }
+    sendBatch();
+    m_replaying = false;
+
+    stats.duration = std::chrono::steady_clock::now() - started;
+    qDebug() << "ZeroMQ replay of" << QString::fromStdString(path) << "sent" << stats.messages
+             << "messages," << stats.failed << "failed, max lag" << stats.max_lag.count() << "ns";
+    return stats;
+}
+
+void ZeroMQHandler::addSocket(const SocketSpec& spec) {
+    if (spec.name.empty()) {
+        throw Error(ErrorCode::INVALID_ARGUMENT, "Socket name must not be empty");
+    }
+    if (!m_running) {
+        throw Error(ErrorCode::INVALID_STATE, "Configure the handler before adding sockets");
+    }
+
+    // Set up here so bind and connect errors reach the caller
+    auto named = std::make_unique<NamedSocket>();
+    named->spec = spec;
+    try {
+        named->socket = zmq::socket_t(m_context, socketType(spec.role));
+        applyProfile(named->socket, m_profile);
+        int timeout = m_profile.timeout >= 0 ? m_profile.timeout : m_timeout;
+        named->socket.set(zmq::sockopt::rcvtimeo, timeout);
+        named->socket.set(zmq::sockopt::sndtimeo, timeout);
+        if (spec.role == Role::SUBSCRIBER) {
+            if (spec.topics.empty()) {
+                named->socket.set(zmq::sockopt::subscribe, "");
+            }
+            for (const auto& topic : spec.topics) {
+                named->socket.set(zmq::sockopt::subscribe, topic);
             }
+        } else if (spec.role == Role::REQUESTER) {
+            // Sends are not held back by replies that never come
+            named->socket.set(zmq::sockopt::req_relaxed, 1);
+            named->socket.set(zmq::sockopt::req_correlate, 1);
+        }
+
+        if (isBindingRole(spec.role)) {
+            named->socket.bind(wildcardEndpoint(spec.endpoint));
+        } else {
+            named->socket.connect(spec.endpoint);
         }
     } catch (const zmq::error_t& e) {
-        if (e.num() != EAGAIN) {  // Ignore would-block errors
-            qDebug() << "Error in DEALER-ROUTER message handling:" << e.what();
-            emit errorOccurred(QString::fromStdString(e.what()));
+        throw Error(ErrorCode::ZMQ_ERROR, "Failed to open socket " + spec.name + ": " + e.what());
+    }
+
+    std::promise<bool> done;
+    auto added = done.get_future();
+    post([this, named = std::move(named), done = std::move(done)](zmq::socket_t* socket) mutable {
+        if (!socket || findSocket(named->spec.name)) {
+            done.set_value(false);
+            return;
+        }
+        m_sockets.push_back(std::move(named));
+        m_socketsChanged = true;
+        done.set_value(true);
+    });
+    if (!added.get()) {
+        throw Error(ErrorCode::INVALID_ARGUMENT, "Socket " + spec.name + " exists or the handler was closed");
+    }
+    qDebug() << "Added" << roleToString(spec.role) << "socket" << QString::fromStdString(spec.name) << "on"
+             << QString::fromStdString(spec.endpoint);
+}
+
+void ZeroMQHandler::removeSocket(const std::string& name) {
+    std::promise<void> done;
+    auto removed = done.get_future();
+    post([this, &name, done = std::move(done)](zmq::socket_t*) mutable {
+        auto it = std::find_if(m_sockets.begin(), m_sockets.end(),
+                               [&name](const auto& named) { return named->spec.name == name; });
+        if (it != m_sockets.end()) {
+            m_sockets.erase(it);
+            m_socketsChanged = true;
+        }
+        done.set_value();
+    });
+    removed.wait();
+}
+
+std::size_t ZeroMQHandler::send(const std::string& name, const std::vector<std::vector<Frame>>& messages) {
+    std::promise<std::optional<std::size_t>> done;
+    auto result = done.get_future();
+    post([this, &name, &messages, done = std::move(done)](zmq::socket_t* socket) mutable {
+        auto* named = socket ? findSocket(name) : nullptr;
+        if (!named) {
+            done.set_value(std::nullopt);
+            return;
+        }
+        std::size_t sent = 0;
+        for (const auto& frames : messages) {
+            if (!sendFrames(named->socket, frames, false, ZMQ_DONTWAIT)) {
+                break;
+            }
+            named->metrics.countSent(frameBytes(frames));
+            ++sent;
+        }
+        done.set_value(sent);
+    });
+
+    auto sent = result.get();
+    if (!sent) {
+        throw Error(ErrorCode::INVALID_ARGUMENT, "No socket named " + name);
+    }
+    return *sent;
+}
+
+std::vector<ZeroMQHandler::SocketMetrics> ZeroMQHandler::socketMetrics() {
+    auto snapshot = [](const std::string& name, Role role, const std::string& endpoint, const Metrics& metrics) {
+        return SocketMetrics{name, role, endpoint, metrics.messagesReceived, metrics.messagesSent,
+                             metrics.bytesReceived, metrics.bytesSent};
+    };
+
+    std::vector<SocketMetrics> result;
+    result.push_back(snapshot("", m_role, m_endpoint, m_metrics));
+
+    std::promise<void> done;
+    auto collected = done.get_future();
+    post([this, &result, &snapshot, done = std::move(done)](zmq::socket_t*) mutable {
+        for (const auto& named : m_sockets) {
+            result.push_back(snapshot(named->spec.name, named->spec.role, named->spec.endpoint, named->metrics));
+        }
+        done.set_value();
+    });
+    collected.wait();
+    return result;
+}
+
+ZeroMQHandler::NamedSocket* ZeroMQHandler::findSocket(const std::string& name) {
+    for (const auto& named : m_sockets) {
+        if (named->spec.name == name) {
+            return named.get();
+        }
+    }
+    return nullptr;
+}
+
+// Runs on the poll thread
+void ZeroMQHandler::handleNamedSocket(NamedSocket& named) {
+    // REP cannot receive again before its reply is out
+    if (named.unsentReply) {
+        if (!sendFrames(named.socket, *named.unsentReply, false, ZMQ_DONTWAIT)) {
+            if (zmq_errno() == EAGAIN) {
+                return;
+            }
+        } else {
+            named.metrics.countSent(frameBytes(*named.unsentReply));
+        }
+        named.unsentReply.reset();
+    }
+
+    std::vector<Frame> frames;
+    for (int i = 0; i < m_receiveBatch && receiveFrames(named.socket, frames, ZMQ_DONTWAIT); ++i) {
+        named.metrics.countReceived(frameBytes(frames));
+
+        // Answered like the configured socket answers, just without the per-peer queues
+        if (named.spec.role == Role::REPLIER) {
+            frames.back() = Frame::fromString("Reply to: " + std::string(frames.back().data));
+        } else if (named.spec.role == Role::ROUTER && frames.size() >= 2) {
+            frames.back() = Frame::fromString("Response to: " + std::string(frames.back().data));
+        } else {
+            continue;
+        }
+        if (sendFrames(named.socket, frames, false, ZMQ_DONTWAIT)) {
+            named.metrics.countSent(frameBytes(frames));
+        } else if (zmq_errno() == EAGAIN) {
+            // Kept until the pipe has room; the poll loop waits for POLLOUT instead of reading
+            named.unsentReply = std::move(frames);
+            return;
         }
     }
 }
 
-void ZeroMQHandler::processIncomingMessage(const zmq::message_t& identity, zmq::message_t& message) {
+void ZeroMQHandler::processIncomingMessage(const std::vector<Frame>& frames) {
     try {
-        std::string messageStr(static_cast<char*>(message.data()), message.size());
-        
         // Update metrics
-        m_metrics.messagesReceived++;
-        m_metrics.bytesReceived += messageStr.size();
-        
-        // For ROUTER role, handle identity
-        if (m_role == Role::ROUTER && !identity.empty()) {
-            std::string identityStr(static_cast<const char*>(identity.data()), identity.size());
-            m_identity = identityStr;
-            qDebug() << "ROUTER received message from client:" << QString::fromStdString(identityStr);
-            
-            std::lock_guard<std::mutex> lock(m_routerQueuesMutex);
-            m_routerQueues[identityStr].push(messageStr);
-        }
-        
+        m_metrics.countReceived(frameBytes(frames));
+
         // Emit messages for all patterns except REQ-REP
         if (m_pattern != Pattern::REQ_REP) {
-            emit messageReceived(QString::fromStdString(messageStr));
+            emit messageReceived(displayText(frames));
         }
-        
+
     } catch (const std::exception& e) {
         emit errorOccurred(QString::fromStdString(e.what()));
     }
 }
 
-bool ZeroMQHandler::sendMessage(const std::string& message, bool more) {
-    if (!m_socket) return false;
+// Uses the C API so failures are reported through zmq_errno() instead of zmq::error_t
+bool ZeroMQHandler::sendFrames(zmq::socket_t& socket, const std::vector<Frame>& frames, bool more, int flags) {
+    for (std::size_t i = 0; i < frames.size(); ++i) {
+        const auto& frame = frames[i];
+        int part_flags = flags | ((more || i + 1 < frames.size()) ? ZMQ_SNDMORE : 0);
 
-    try {
-        zmq::message_t msg(message.data(), message.size());
-        zmq::send_flags flags = more ? zmq::send_flags::sndmore : zmq::send_flags::none;
-        return m_socket->send(msg, flags).has_value();
-    } catch (const zmq::error_t& e) {
-        qDebug() << "ZMQ send error:" << e.what();
-        return false;
+        // Large frames keep a reference to their owner until libzmq has sent them
+        auto part = frame.data.size() >= kZeroCopyThreshold
+            ? zmq::message_t(const_cast<char*>(frame.data.data()), frame.data.size(), releaseFrame,
+                             new std::shared_ptr<const void>(frame.owner))
+            : zmq::message_t(frame.data.data(), frame.data.size());
+        if (zmq_msg_send(part.handle(), socket.handle(), part_flags) < 0) {
+            if (zmq_errno() != EAGAIN) {
+                qDebug() << "ZMQ send error:" << zmq_strerror(zmq_errno());
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ZeroMQHandler::receiveFrames(zmq::socket_t& socket, std::vector<Frame>& frames, int flags) {
+    frames.clear();
+    bool more = true;
+    while (more) {
+        // Heap allocated so the view stays valid, small messages keep their bytes inline
+        auto part = std::make_shared<zmq::message_t>();
+        if (zmq_msg_recv(part->handle(), socket.handle(), frames.empty() ? flags : 0) < 0) {
+            return false;
+        }
+        more = zmq_msg_more(part->handle()) != 0;
+        std::string_view data(static_cast<const char*>(part->data()), part->size());
+        frames.push_back(Frame{std::move(part), data});
+    }
+    return true;
+}
+
+QString ZeroMQHandler::displayText(const std::vector<Frame>& frames) {
+    QString text;
+    for (const auto& frame : frames) {
+        if (!text.isEmpty()) {
+            text += " | ";
+        }
+        text += QString::fromUtf8(frame.data.data(), static_cast<qsizetype>(frame.data.size()));
     }
+    return text;
+}
+
+std::unexpected<Error> ZeroMQHandler::lastZmqError(const std::string& context) {
+    int err = zmq_errno();
+    auto code = err == EAGAIN ? ErrorCode::TIMEOUT : ErrorCode::ZMQ_ERROR;
+    return makeError(code, context + ": " + zmq_strerror(err));
 }
 
 void ZeroMQHandler::stopPolling() {
-    m_running = false;
+    if (!m_pollThread) {
+        return;
+    }
+    {
+        // Tasks posted after this run inline with no socket
+        std::lock_guard<std::mutex> lock(m_taskMutex);
+        m_running = false;
+    }
+    wake();
     
     if (m_pollThread && m_pollThread->joinable()) {
         try {
@@ -0,0 +1,176 @@
+#include "core/zmq_capture.hpp"
+#include "core/error.hpp"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <QDebug>
+#include <QFile>
+
+namespace flowdriver {
+
+namespace {
+    constexpr char kMagic[8] = {'F', 'D', 'Z', 'C', 'A', 'P', '1', '\n'};
+    constexpr std::uint32_t kRoutedFlag = 1;
+
+    // Records are written out once this much has accumulated, or kFlushInterval passed
+    constexpr std::size_t kBufferSize = 1 << 20;
+}
+
+CaptureWriter::CaptureWriter(const std::string& path)
+    : m_path(path)
+{
+    std::error_code ec;
+    bool resume = std::filesystem::exists(path, ec) && std::filesystem::file_size(path, ec) > 0;
+    if (resume) {
+        // A record torn by a crash would corrupt everything appended after it
+        std::size_t complete = 0;
+        {
+            CaptureReader reader(path);
+            while (reader.next()) {
+                ++m_records;
+            }
+            complete = reader.position();
+        }
+        std::filesystem::resize_file(path, complete, ec);
+        if (ec) {
+            throw Error(ErrorCode::INVALID_ARGUMENT, "Cannot continue capture " + path + ": " + ec.message());
+        }
+    }
+
+    m_out.open(path, std::ios::binary | std::ios::app);
+    if (!m_out) {
+        throw Error(ErrorCode::INVALID_ARGUMENT, "Cannot open capture file " + path);
+    }
+    if (!resume) {
+        m_out.write(kMagic, sizeof(kMagic));
+    }
+    m_buffer.reserve(kBufferSize);
+
+    qDebug() << (resume ? "Continuing" : "Starting") << "ZeroMQ capture" << QString::fromStdString(path)
+             << "at" << m_records << "records";
+}
+
+CaptureWriter::~CaptureWriter() {
+    try {
+        flush();
+    } catch (const Error& e) {
+        qDebug() << "Capture lost its last records:" << e.what();
+    }
+}
+
+void CaptureWriter::append(std::int64_t timestamp_ns, const std::vector<Frame>& frames, bool routed) {
+    auto put = [this](const auto& value) {
+        m_buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+    put(timestamp_ns);
+    put(routed ? kRoutedFlag : std::uint32_t{0});
+    put(static_cast<std::uint32_t>(frames.size()));
+    for (const auto& frame : frames) {
+        put(static_cast<std::uint32_t>(frame.data.size()));
+        m_buffer.append(frame.data);
+    }
+    ++m_records;
+
+    if (m_buffer.size() >= kBufferSize) {
+        flush();
+    } else {
+        flushIfDue();
+    }
+}
+
+void CaptureWriter::flush() {
+    if (m_buffer.empty()) {
+        return;
+    }
+    m_out.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+    m_out.flush();
+    m_buffer.clear();
+    m_lastFlush = std::chrono::steady_clock::now();
+    if (!m_out) {
+        throw Error(ErrorCode::INTERNAL_ERROR, "Failed to write capture file " + m_path);
+    }
+}
+
+void CaptureWriter::flushIfDue() {
+    if (!m_buffer.empty() && std::chrono::steady_clock::now() - m_lastFlush >= kFlushInterval) {
+        flush();
+    }
+}
+
+/**
+ * @brief Read-only mapping of a capture file, shared by the frames read from it
+ */
+struct CaptureReader::Mapping {
+    QFile file;
+    const char* data{nullptr};
+    std::size_t size{0};
+
+    ~Mapping() {
+        if (data) {
+            file.unmap(reinterpret_cast<uchar*>(const_cast<char*>(data)));
+        }
+    }
+};
+
+CaptureReader::CaptureReader(const std::string& path) {
+    auto mapping = std::make_shared<Mapping>();
+    mapping->file.setFileName(QString::fromStdString(path));
+    if (!mapping->file.open(QIODevice::ReadOnly)) {
+        throw Error(ErrorCode::INVALID_ARGUMENT,
+                    "Cannot open capture file " + path + ": " + mapping->file.errorString().toStdString());
+    }
+
+    mapping->size = static_cast<std::size_t>(mapping->file.size());
+    if (mapping->size >= sizeof(kMagic)) {
+        mapping->data = reinterpret_cast<const char*>(mapping->file.map(0, mapping->file.size()));
+    }
+    if (!mapping->data || std::memcmp(mapping->data, kMagic, sizeof(kMagic)) != 0) {
+        throw Error(ErrorCode::PARSE_ERROR, path + " is not a ZeroMQ capture");
+    }
+
+    m_mapping = std::move(mapping);
+    m_offset = sizeof(kMagic);
+}
+
+std::optional<CaptureReader::Record> CaptureReader::next() {
+    const char* data = m_mapping->data;
+    std::size_t size = m_mapping->size;
+    std::size_t offset = m_offset;
+
+    auto take = [&](auto& value) {
+        if (size - offset < sizeof(value)) {
+            return false;
+        }
+        std::memcpy(&value, data + offset, sizeof(value));
+        offset += sizeof(value);
+        return true;
+    };
+
+    Record record;
+    std::uint32_t flags = 0;
+    std::uint32_t count = 0;
+    if (!take(record.timestamp_ns) || !take(flags) || !take(count)) {
+        return std::nullopt;
+    }
+    record.routed = (flags & kRoutedFlag) != 0;
+
+    // Every frame needs at least its length, a torn count cannot over-allocate
+    record.frames.reserve(std::min<std::size_t>(count, (size - offset) / sizeof(std::uint32_t)));
+    for (std::uint32_t i = 0; i < count; ++i) {
+        std::uint32_t length = 0;
+        if (!take(length) || size - offset < length) {
+            return std::nullopt;
+        }
+        record.frames.push_back(Frame{m_mapping, std::string_view(data + offset, length)});
+        offset += length;
+    }
+
+    m_offset = offset;
+    return record;
+}
+
+void CaptureReader::rewind() {
+    m_offset = sizeof(kMagic);
+}
+
+} // namespace flowdriver
@@ -0,0 +1,379 @@
+#include "core/zmq_proxy.hpp"
+#include "core/error.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <QDebug>
+
+namespace flowdriver {
+
+namespace {
+    // Copies queued for the capture reader before the proxy drops further ones
+    constexpr int kCaptureHwm = 100000;
+
+    // Capture messages handled per lock of the statistics
+    constexpr int kCaptureBatch = 256;
+
+    // How often the capture reader checks for shutdown while idle
+    constexpr std::chrono::milliseconds kCapturePoll{100};
+
+    // Messages moved per readiness event before the other side gets a turn
+    constexpr int kForwardBatch = 256;
+
+    // Requests whose reply never came are forgotten after this long
+    constexpr std::chrono::seconds kRoundTripHorizon{60};
+    constexpr std::size_t kMaxOutstanding = 65536;
+
+    std::string proxyEndpoint(std::string_view kind, const void* owner) {
+        return "inproc://flowdriver-proxy-" + std::string(kind) + "-" +
+               std::to_string(reinterpret_cast<std::uintptr_t>(owner));
+    }
+}
+
+ZmqProxy::ZmqProxy(Config config)
+    : m_config(std::move(config))
+    , m_context(std::max(m_config.profile.io_threads, 1))
+{
+}
+
+ZmqProxy::~ZmqProxy() {
+    terminate();
+}
+
+void ZmqProxy::start() {
+    if (m_state != State::STOPPED) {
+        throw Error(ErrorCode::INVALID_STATE, "Proxy is already running");
+    }
+
+    bool pubsub = m_config.kind == Kind::XPUB_XSUB;
+    m_frontend = zmq::socket_t(m_context, pubsub ? zmq::socket_type::xsub : zmq::socket_type::router);
+    m_backend = zmq::socket_t(m_context, pubsub ? zmq::socket_type::xpub : zmq::socket_type::dealer);
+    ZeroMQHandler::applyProfile(m_frontend, m_config.profile);
+    ZeroMQHandler::applyProfile(m_backend, m_config.profile);
+
+    try {
+        if (!m_config.capture_path.empty()) {
+            m_writer = std::make_unique<CaptureWriter>(m_config.capture_path);
+        }
+        m_frontend.bind(m_config.frontend);
+        m_backend.bind(m_config.backend);
+    } catch (const zmq::error_t& e) {
+        m_writer.reset();
+        m_frontend.close();
+        m_backend.close();
+        throw Error(ErrorCode::ZMQ_ERROR, std::string("Failed to bind proxy: ") + e.what());
+    } catch (const Error&) {
+        m_frontend.close();
+        m_backend.close();
+        throw;
+    }
+
+    // Copies are published so a slow reader loses them instead of stalling the proxy
+    auto captureEndpoint = proxyEndpoint("capture", this);
+    m_captureIn = zmq::socket_t(m_context, zmq::socket_type::sub);
+    m_captureIn.set(zmq::sockopt::rcvhwm, kCaptureHwm);
+    m_captureIn.set(zmq::sockopt::linger, 0);
+    m_captureIn.set(zmq::sockopt::subscribe, "");
+    m_captureIn.bind(captureEndpoint);
+    m_captureOut = zmq::socket_t(m_context, zmq::socket_type::pub);
+    m_captureOut.set(zmq::sockopt::sndhwm, kCaptureHwm);
+    m_captureOut.set(zmq::sockopt::linger, 0);
+    m_captureOut.connect(captureEndpoint);
+
+    auto controlEndpoint = proxyEndpoint("control", this);
+    m_controlIn = zmq::socket_t(m_context, zmq::socket_type::pair);
+    m_controlIn.set(zmq::sockopt::linger, 0);
+    m_controlIn.bind(controlEndpoint);
+    m_controlOut = zmq::socket_t(m_context, zmq::socket_type::pair);
+    m_controlOut.set(zmq::sockopt::linger, 0);
+    m_controlOut.connect(controlEndpoint);
+
+    {
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        m_captured = 0;
+        m_recorded = 0;
+        m_roundTrips = 0;
+        m_roundTripMin = std::chrono::nanoseconds::max();
+        m_roundTripMax = std::chrono::nanoseconds(0);
+        m_roundTripTotal = std::chrono::nanoseconds(0);
+        m_outstanding.clear();
+    }
+    m_upstream.messages = 0;
+    m_upstream.bytes = 0;
+    m_downstream.messages = 0;
+    m_downstream.bytes = 0;
+
+    m_started = std::chrono::steady_clock::now();
+    m_state = State::RUNNING;
+    m_capturing = true;
+    m_captureThread = std::thread([this]() { captureLoop(); });
+
+    // Socket ownership passes to the proxy thread until it returns
+    m_proxyThread = std::thread([this]() { forwardLoop(); });
+
+    qDebug() << "ZMQ proxy forwarding" << QString::fromStdString(m_config.frontend) << "<->"
+             << QString::fromStdString(m_config.backend) << (pubsub ? "(XSUB/XPUB)" : "(ROUTER/DEALER)");
+}
+
+void ZmqProxy::pause() {
+    if (m_state != State::RUNNING) {
+        throw Error(ErrorCode::INVALID_STATE, "Proxy is not running");
+    }
+    sendCommand("PAUSE");
+    m_state = State::PAUSED;
+}
+
+void ZmqProxy::resume() {
+    if (m_state != State::PAUSED) {
+        throw Error(ErrorCode::INVALID_STATE, "Proxy is not paused");
+    }
+    sendCommand("RESUME");
+    m_state = State::RUNNING;
+}
+
+void ZmqProxy::terminate() {
+    if (m_state == State::STOPPED) {
+        return;
+    }
+
+    sendCommand("TERMINATE");
+    if (m_proxyThread.joinable()) {
+        m_proxyThread.join();
+    }
+    m_capturing = false;
+    if (m_captureThread.joinable()) {
+        m_captureThread.join();
+    }
+    m_writer.reset();
+    m_lastStats = stats();
+
+    m_frontend.close();
+    m_backend.close();
+    m_captureOut.close();
+    m_captureIn.close();
+    m_controlIn.close();
+    m_controlOut.close();
+    m_state = State::STOPPED;
+
+    qDebug() << "ZMQ proxy terminated after" << m_lastStats.frontend_to_backend.messages << "/"
+             << m_lastStats.backend_to_frontend.messages << "messages";
+}
+
+ZmqProxy::Stats ZmqProxy::stats() {
+    if (m_state == State::STOPPED && !m_proxyThread.joinable()) {
+        return m_lastStats;
+    }
+
+    Stats stats;
+    stats.frontend_to_backend = Direction{m_upstream.messages, m_upstream.bytes};
+    stats.backend_to_frontend = Direction{m_downstream.messages, m_downstream.bytes};
+    {
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        stats.captured = m_captured;
+        stats.recorded = m_recorded;
+        stats.round_trips = m_roundTrips;
+        if (m_roundTrips > 0) {
+            stats.round_trip_min = m_roundTripMin;
+            stats.round_trip_max = m_roundTripMax;
+            stats.round_trip_mean = m_roundTripTotal / m_roundTrips;
+        }
+    }
+    stats.elapsed = std::chrono::steady_clock::now() - m_started;
+    return stats;
+}
+
+void ZmqProxy::sendCommand(const char* command) {
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+    m_controlOut.send(zmq::buffer(command, std::strlen(command)));
+}
+
+void ZmqProxy::forwardLoop() {
+    zmq::pollitem_t items[] = {
+        { m_controlIn.handle(), 0, ZMQ_POLLIN, 0 },
+        { m_frontend.handle(), 0, 0, 0 },
+        { m_backend.handle(), 0, 0, 0 }
+    };
+    bool paused = false;
+
+    while (true) {
+        try {
+            // A side is only read while the other can take its messages, otherwise
+            // the proxy waits for room there instead of blocking in a send
+            bool upstreamOpen = (m_backend.get(zmq::sockopt::events) & ZMQ_POLLOUT) != 0;
+            bool downstreamOpen = (m_frontend.get(zmq::sockopt::events) & ZMQ_POLLOUT) != 0;
+            items[1].events = paused ? 0 : static_cast<short>((upstreamOpen ? ZMQ_POLLIN : 0) |
+                                                              (downstreamOpen ? 0 : ZMQ_POLLOUT));
+            items[2].events = paused ? 0 : static_cast<short>((downstreamOpen ? ZMQ_POLLIN : 0) |
+                                                              (upstreamOpen ? 0 : ZMQ_POLLOUT));
+            zmq::poll(items, 3, std::chrono::milliseconds(-1));
+
+            if (items[0].revents & ZMQ_POLLIN) {
+                zmq::message_t command;
+                while (m_controlIn.recv(command, zmq::recv_flags::dontwait)) {
+                    auto text = command.to_string_view();
+                    if (text == "TERMINATE") {
+                        return;
+                    }
+                    if (text == "PAUSE" || text == "RESUME") {
+                        paused = text == "PAUSE";
+                    } else {
+                        qDebug() << "ZMQ proxy ignoring command" << QString::fromStdString(std::string(text));
+                    }
+                }
+            }
+            if (paused) {
+                continue;
+            }
+
+            if (items[1].revents & ZMQ_POLLIN) {
+                forward(m_frontend, m_backend, Flow::UPSTREAM, m_upstream);
+            }
+            if (items[2].revents & ZMQ_POLLIN) {
+                forward(m_backend, m_frontend, Flow::DOWNSTREAM, m_downstream);
+            }
+        } catch (const zmq::error_t& e) {
+            if (e.num() == ETERM) {
+                return;
+            }
+            qDebug() << "Error in proxy thread:" << e.what();
+        }
+    }
+}
+
+void ZmqProxy::forward(zmq::socket_t& from, zmq::socket_t& to, Flow flow, Counters& counters) {
+    for (int i = 0; i < kForwardBatch; ++i) {
+        if (!(to.get(zmq::sockopt::events) & ZMQ_POLLOUT)) {
+            return;
+        }
+        zmq::message_t part;
+        if (!from.recv(part, zmq::recv_flags::dontwait)) {
+            return;
+        }
+
+        // The copy leads with the direction; PUB drops it whole if the reader lags
+        const char tag = static_cast<char>(flow);
+        m_captureOut.send(zmq::buffer(&tag, 1), zmq::send_flags::sndmore | zmq::send_flags::dontwait);
+
+        std::size_t bytes = 0;
+        bool delivered = true;
+        while (true) {
+            bool more = part.more();
+            auto flags = (more ? zmq::send_flags::sndmore : zmq::send_flags::none) | zmq::send_flags::dontwait;
+            bytes += part.size();
+
+            // Shares the payload of large parts instead of duplicating it
+            zmq::message_t copy;
+            copy.copy(part);
+            m_captureOut.send(copy, flags);
+
+            // Only the first part can find the pipe full, the rest of a message follows it
+            if (delivered && !to.send(part, flags)) {
+                delivered = false;
+                qDebug() << "ZMQ proxy dropped a message, its destination filled up";
+            }
+            if (!more) {
+                break;
+            }
+            // Remaining parts of a message arrive together with the first
+            (void)from.recv(part);
+        }
+        if (delivered) {
+            counters.messages++;
+            counters.bytes += bytes;
+        }
+    }
+}
+
+void ZmqProxy::captureLoop() {
+    zmq::pollitem_t item{ m_captureIn.handle(), 0, ZMQ_POLLIN, 0 };
+    std::vector<Frame> frames;
+    bool routed = m_config.kind == Kind::ROUTER_DEALER;
+
+    while (m_capturing) {
+        try {
+            if (zmq::poll(&item, 1, kCapturePoll) == 0) {
+                // A quiet proxy still gets its last records to the file
+                if (m_writer) {
+                    try {
+                        m_writer->flushIfDue();
+                    } catch (const Error& e) {
+                        qDebug() << "ZMQ proxy capture stopped:" << e.what();
+                        m_writer.reset();
+                    }
+                }
+                continue;
+            }
+
+            std::lock_guard<std::mutex> lock(m_statsMutex);
+            for (int i = 0; i < kCaptureBatch && ZeroMQHandler::receiveFrames(m_captureIn, frames, ZMQ_DONTWAIT); ++i) {
+                if (frames.size() < 2 || frames.front().data.size() != 1) {
+                    continue;
+                }
+                auto flow = static_cast<Flow>(frames.front().data.front());
+                frames.erase(frames.begin());
+                ++m_captured;
+
+                if (routed) {
+                    trackRoundTrip(flow, frames, std::chrono::steady_clock::now());
+                }
+
+                // Publications or requests, what a replaying socket would send again;
+                // subscriptions and replies only ever travel downstream
+                if (flow != Flow::UPSTREAM || !m_writer) {
+                    continue;
+                }
+
+                try {
+                    auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::system_clock::now().time_since_epoch());
+                    m_writer->append(now.count(), frames, routed);
+                    ++m_recorded;
+                } catch (const Error& e) {
+                    // Forwarding and metrics carry on without the recording
+                    qDebug() << "ZMQ proxy capture stopped:" << e.what();
+                    m_writer.reset();
+                }
+            }
+        } catch (const zmq::error_t& e) {
+            if (e.num() == ETERM) {
+                break;
+            }
+            qDebug() << "Error in proxy capture thread:" << e.what();
+        }
+    }
+}
+
+void ZmqProxy::trackRoundTrip(Flow flow, const std::vector<Frame>& frames, std::chrono::steady_clock::time_point seen) {
+    // [identity, correlation, "", body...]: a correlating ZeroMQHandler DEALER behind the
+    // ROUTER, whose worker echoes the envelope. Without it replies cannot be matched reliably.
+    if (frames.size() < 4 || frames[1].data.size() != sizeof(uint64_t) || !frames[2].data.empty()) {
+        return;
+    }
+    // Correlation IDs have a fixed size, so the key cannot alias another client's
+    std::string key(frames[0].data);
+    key.append(frames[1].data);
+
+    if (flow == Flow::UPSTREAM) {
+        if (m_outstanding.size() >= kMaxOutstanding) {
+            std::erase_if(m_outstanding, [seen](const auto& entry) { return seen - entry.second > kRoundTripHorizon; });
+            if (m_outstanding.size() >= kMaxOutstanding) {
+                m_outstanding.clear();
+            }
+        }
+        m_outstanding[std::move(key)] = seen;
+        return;
+    }
+
+    auto it = m_outstanding.find(key);
+    if (it == m_outstanding.end()) {
+        return;
+    }
+    auto roundTrip = std::chrono::duration_cast<std::chrono::nanoseconds>(seen - it->second);
+    m_outstanding.erase(it);
+    ++m_roundTrips;
+    m_roundTripMin = std::min(m_roundTripMin, roundTrip);
+    m_roundTripMax = std::max(m_roundTripMax, roundTrip);
+    m_roundTripTotal += roundTrip;
+}
+
+} // namespace flowdriver
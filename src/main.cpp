@@ -6,6 +6,7 @@
 #include "models/response_model.hpp"
 #include "models/request_manager.hpp"
 #include "models/query_model.hpp"
+#include "models/message_list_model.hpp"
 
 int main(int argc, char *argv[]) {
     QGuiApplication app(argc, argv);
@@ -15,6 +16,8 @@ int main(int argc, char *argv[]) {
     qmlRegisterType<flowdriver::ui::AuthModel>("FlowDriver.UI", 1, 0, "AuthModel");
     qmlRegisterType<flowdriver::ui::QueryModel>("FlowDriver.UI", 1, 0, "QueryModel");
     qmlRegisterType<flowdriver::ui::ResponseModel>("FlowDriver.UI", 1, 0, "ResponseModel");
+    qmlRegisterUncreatableType<flowdriver::ui::MessageListModel>("FlowDriver.UI", 1, 0, "MessageListModel",
+                                                                 "Provided by RequestManager.messages");
 
     // Main manager for handling requests
     qmlRegisterType<flowdriver::ui::RequestManager>("FlowDriver.UI", 1, 0, "RequestManager");
@@ -0,0 +1,146 @@
+#include "models/message_list_model.hpp"
+#include <QDateTime>
+#include <algorithm>
+#include <optional>
+#include <vector>
+
+namespace flowdriver::ui {
+
+namespace {
+    // Messages buffered between two flushes before new ones are dropped
+    constexpr std::size_t kIncomingCapacity = 16384;
+
+    // About one frame at 60 Hz
+    constexpr int kFlushIntervalMs = 16;
+}
+
+MessageListModel::MessageListModel(QObject* parent)
+    : QAbstractListModel(parent)
+    , m_incoming(kIncomingCapacity)
+{
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(kFlushIntervalMs);
+    connect(&m_flushTimer, &QTimer::timeout, this, &MessageListModel::flush);
+}
+
+int MessageListModel::rowCount(const QModelIndex& parent) const {
+    if (parent.isValid()) return 0;
+
+    return static_cast<int>(m_messages.size());
+}
+
+QVariant MessageListModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() >= static_cast<int>(m_messages.size())) return QVariant();
+
+    const Message& message = m_messages[index.row()];
+
+    switch (role) {
+        case DirectionRole:
+            return message.direction;
+        case MessageRole:
+            return message.text;
+        case TimestampRole:
+            return QDateTime::fromMSecsSinceEpoch(message.timestamp).toString("hh:mm:ss.zzz");
+        default:
+            return QVariant();
+    }
+}
+
+QHash<int, QByteArray> MessageListModel::roleNames() const {
+    QHash<int, QByteArray> roles;
+    roles[DirectionRole] = "direction";
+    roles[MessageRole] = "message";
+    roles[TimestampRole] = "timestamp";
+    return roles;
+}
+
+void MessageListModel::post(const QString& direction, const QString& message) {
+    if (!m_incoming.tryPush(Message{direction, message, QDateTime::currentMSecsSinceEpoch()})) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // The first message after a flush arms the timer, later ones ride along
+    if (!m_flushScheduled.exchange(true, std::memory_order_acq_rel)) {
+        QMetaObject::invokeMethod(&m_flushTimer, [this]() { m_flushTimer.start(); }, Qt::QueuedConnection);
+    }
+}
+
+void MessageListModel::flush() {
+    // Cleared before draining, a message posted meanwhile arms the next flush
+    m_flushScheduled.store(false, std::memory_order_release);
+
+    std::vector<Message> batch;
+    Message message;
+    while (m_incoming.tryPop(message)) {
+        batch.push_back(std::move(message));
+    }
+
+    auto latest = std::find_if(batch.rbegin(), batch.rend(),
+                               [](const Message& m) { return m.direction == "Received"; });
+    std::optional<QString> latestText;
+    if (latest != batch.rend()) {
+        latestText = latest->text;
+    }
+
+    // Rows that would be trimmed right away are never inserted
+    auto limit = static_cast<std::size_t>(m_maxHistory);
+    auto skipped = batch.size() > limit ? batch.size() - limit : 0;
+    m_evicted += skipped;
+
+    if (batch.size() > skipped) {
+        auto first = static_cast<int>(m_messages.size());
+        beginInsertRows(QModelIndex(), first, first + static_cast<int>(batch.size() - skipped) - 1);
+        for (auto it = batch.begin() + skipped; it != batch.end(); ++it) {
+            m_messages.push_back(std::move(*it));
+        }
+        endInsertRows();
+    }
+    trim();
+
+    emit countChanged();
+    emit statsChanged();
+    if (latestText) {
+        emit latestReceived(*latestText);
+    }
+}
+
+void MessageListModel::trim() {
+    auto limit = static_cast<std::size_t>(m_maxHistory);
+    if (m_messages.size() <= limit) {
+        return;
+    }
+
+    auto excess = m_messages.size() - limit;
+    beginRemoveRows(QModelIndex(), 0, static_cast<int>(excess) - 1);
+    m_messages.erase(m_messages.begin(), m_messages.begin() + excess);
+    endRemoveRows();
+    m_evicted += excess;
+}
+
+void MessageListModel::setMaxHistory(int maxHistory) {
+    maxHistory = std::max(maxHistory, 1);
+    if (m_maxHistory == maxHistory) {
+        return;
+    }
+    m_maxHistory = maxHistory;
+    trim();
+    emit maxHistoryChanged();
+    emit countChanged();
+    emit statsChanged();
+}
+
+void MessageListModel::clear() {
+    beginResetModel();
+    m_messages.clear();
+    Message message;
+    while (m_incoming.tryPop(message)) {
+    }
+    endResetModel();
+
+    m_evicted = 0;
+    m_dropped.store(0, std::memory_order_relaxed);
+    emit countChanged();
+    emit statsChanged();
+}
+
+} // namespace flowdriver::ui
@@ -2,6 +2,10 @@
 #include "core/rest_handler.hpp"
 #include "core/websocket_handler.hpp"
 #include "core/zeromq_handler.hpp"
+#include "core/executor.hpp"
+#include <boost/asio/co_spawn.hpp>
+#include <QCoreApplication>
+#include <QPointer>
 #include <QVariantMap>
 #include <QTimer>
 #include <iostream>
@@ -14,32 +18,69 @@
 
 namespace flowdriver::ui {
 
+namespace {
+    qint64 toMicroseconds(std::chrono::nanoseconds value) {
+        return static_cast<qint64>(std::chrono::duration_cast<std::chrono::microseconds>(value).count());
+    }
+
+    QVariantMap histogramToVariantMap(const testing::LatencyHistogram& histogram) {
+        QVariantMap map;
+        map["count"] = static_cast<qulonglong>(histogram.count());
+        if (histogram.count() == 0) {
+            return map;
+        }
+        map["minUs"] = toMicroseconds(histogram.min());
+        map["meanUs"] = toMicroseconds(histogram.mean());
+        map["p50Us"] = toMicroseconds(histogram.percentile(50.0));
+        map["p99Us"] = toMicroseconds(histogram.percentile(99.0));
+        map["maxUs"] = toMicroseconds(histogram.max());
+        return map;
+    }
+}
+
 RequestManager::RequestManager(QObject* parent)
     : QObject(parent)
     , m_handler(nullptr)
     , m_isLoading(false)
     , m_currentProtocol("REST")  // We start with REST by default
     , m_isConnected(false)
+    , m_httpCache(std::make_shared<HttpCache>())
     , m_protoFilePath("")
+    , m_messages(new MessageListModel(this))
 {
     qDebug() << "RequestManager initializing...";
+
+    // ResponseViewer keeps showing the newest WebSocket or ZeroMQ message, once per batch.
+    // Not responseReceived: the message log appends those, and this one is already in it.
+    connect(m_messages, &MessageListModel::latestReceived, this, [this](const QString& message) {
+        if (m_currentProtocol == "WebSocket" || m_currentProtocol == "ZeroMQ") {
+            QVariantMap response;
+            response["body"] = message;
+            response["status_code"] = 200;
+            emit latestMessageReceived(response);
+        }
+    });
+
     initializeProtocolHandler(); 
     qDebug() << "RequestManager initialized with" << m_currentProtocol << "protocol";
 }
 
+RequestManager::~RequestManager() {
+    finishZmqBenchmark();
+    releaseZmqHandler();
+}
+
 void RequestManager::setCurrentProtocol(const QString& protocol) {
     if (m_currentProtocol != protocol) {
         qDebug() << "Switching protocol from" << m_currentProtocol << "to" << protocol;
         
-        if (m_zmqHandler) {
-            m_zmqHandler->cancel();
-            m_zmqHandler.reset();
-        }
+        releaseZmqHandler();
         if (m_wsHandler) {
             m_wsHandler->cancel();
             m_wsHandler.reset();
         }
         if (m_restHandler) {
+            m_restHandler->cancel();
             m_restHandler.reset();
         }
         if (m_grpcHandler) {
@@ -51,8 +92,7 @@ void RequestManager::setCurrentProtocol(const QString& protocol) {
         
         // FIXME need to implement this more correctly
         if (protocol == "gRPC") {
-            m_grpcHandler = std::make_unique<GrpcHandler>();
-            m_handler = m_grpcHandler.get();
+            createGrpcHandler();
             // If we already have a proto file path, load it
             if (!m_protoFilePath.isEmpty()) {
                 try {
@@ -74,6 +114,7 @@ void RequestManager::setCurrentRole(const QString &role)
 {
     if (m_currentRole != role) {
         m_currentRole = role;
+        m_zmqShowsReceived = showsReceivedMessages(role);
         emit currentRoleChanged();
     }
 }
@@ -138,10 +179,23 @@ void RequestManager::executeRequest(const QString& method, const QString& url, c
             }
         }
         
-        m_currentRequest = m_restHandler->executeAsync(config);
-        
-        // Timer to check for completion of request
-        QTimer::singleShot(COMPLETION_TIMEOUT, this, &RequestManager::checkRequest);
+        // Run the request as a coroutine on the I/O pool and hop back to the
+        // GUI thread on completion, no polling involved
+        const auto requestId = ++m_requestId;
+        QPointer<RequestManager> self(this);
+        boost::asio::co_spawn(
+            Executor::instance().ioContext(),
+            m_restHandler->co_execute(config),
+            [self, requestId](std::exception_ptr error, RequestResult result) {
+                // Runs on an I/O thread: qApp outlives the manager, self is only looked at on the GUI thread
+                QMetaObject::invokeMethod(qApp,
+                    [self, requestId, error, result = std::move(result)]() mutable {
+                        if (self) {
+                            self->completeRequest(requestId, error, std::move(result));
+                        }
+                    },
+                    Qt::QueuedConnection);
+            });
         
         qDebug() << "Executing REST request:" << method << url;
         
@@ -158,6 +212,7 @@ void RequestManager::executeRequest(const QString& method, const QString& url, c
 
 void RequestManager::cancelRequest() {
     if (m_handler && m_isLoading) {
+        ++m_requestId;  // Drop the completion of the cancelled request
         m_handler->cancel();
         m_isLoading = false;
         emit loadingChanged();
@@ -167,15 +222,13 @@ void RequestManager::cancelRequest() {
 void RequestManager::initializeProtocolHandler() {
     qDebug() << "Initializing protocol handler for:" << m_currentProtocol;
     
-    if (m_zmqHandler) {
-        m_zmqHandler->cancel();
-        m_zmqHandler.reset();
-    }
+    releaseZmqHandler();
     if (m_wsHandler) {
         m_wsHandler->cancel();
         m_wsHandler.reset();
     }
     if (m_restHandler) {
+        m_restHandler->cancel();
         m_restHandler.reset();
     }
     
@@ -185,6 +238,7 @@ void RequestManager::initializeProtocolHandler() {
     try {
         if (m_currentProtocol == "REST") {
             m_restHandler = std::make_unique<RestHandler>();
+            m_restHandler->setCache(m_httpCacheEnabled ? m_httpCache : nullptr);
             m_handler = m_restHandler.get();
             qDebug() << "REST handler initialized";
         } else if (m_currentProtocol == "WebSocket") {
@@ -193,33 +247,24 @@ void RequestManager::initializeProtocolHandler() {
                     this, &RequestManager::onWebSocketConnected);
             QObject::connect(m_wsHandler.get(), &WebSocketHandler::disconnected,
                     this, &RequestManager::onWebSocketDisconnected);
-            QObject::connect(m_wsHandler.get(), &WebSocketHandler::messageReceived,
+            // Runs on the WebSocket thread, the model batches messages for the UI
+            QObject::connect(m_wsHandler.get(), &WebSocketHandler::messageReceived, this,
                     [this](const std::string& msg) {
-                        QVariantMap response;
-                        response["body"] = QString::fromStdString(msg);
-                        response["status_code"] = 200;
-                        emit responseReceived(response);
-                    });
+                        m_messages->post("Received", QString::fromStdString(msg));
+                    }, Qt::DirectConnection);
             m_handler = m_wsHandler.get();
             qDebug() << "WebSocket handler initialized";
         } else if (m_currentProtocol == "ZeroMQ") {
             if (!m_zmqHandler) {
                 m_zmqHandler = std::make_unique<ZeroMQHandler>(this);
                 
+                // Runs on the poll thread, the model batches messages for the UI
                 connect(m_zmqHandler.get(), &ZeroMQHandler::messageReceived,
                         this, [this](const QString& message) {
-                            qDebug() << "ZMQ message received:" << message;
-                           
-                            if (m_currentRole == "REPLIER" ||
-                                m_currentRole == "SUBSCRIBER" ||
-                                m_currentRole == "PULLER" ||
-                                m_currentRole == "ROUTER") {
-                                QVariantMap response;
-                                response["body"] = message;
-                                response["status_code"] = 200;
-                                emit responseReceived(response);
+                            if (m_zmqShowsReceived) {
+                                m_messages->post("Received", message);
                             }
-                        });
+                        }, Qt::DirectConnection);
                 
                 connect(m_zmqHandler.get(), &ZeroMQHandler::errorOccurred,
                         this, &RequestManager::errorOccurred);
@@ -304,6 +349,22 @@ void RequestManager::handleZMQError(const QString& error) {
     emit errorOccurred(QString("ZMQ Error: %1").arg(error));
 }
 
+void RequestManager::releaseZmqHandler() {
+    if (!m_zmqHandler) {
+        return;
+    }
+
+    // A replay on the executor uses the handler, end it before the handler goes
+    if (m_zmqReplay.valid()) {
+        do {
+            m_zmqHandler->stopReplay();
+        } while (m_zmqReplay.wait_for(std::chrono::milliseconds(50)) != std::future_status::ready);
+        m_zmqReplay = {};
+    }
+    m_zmqHandler->cancel();
+    m_zmqHandler.reset();
+}
+
 void RequestManager::connectWebSocket(const QString& url) {
     if (!m_wsHandler) {
         emit errorOccurred("WebSocket handler not initialized");
@@ -410,6 +471,14 @@ void RequestManager::executeGrpcRequest(const QString& requestBody) {
         qDebug() << "- Body:" << QString::fromStdString(config.body);
         
         RequestResult result = m_grpcHandler->execute(config);
+
+        // A benchmark on the shared handler may have switched it to BINARY bodies
+        if (result.status_code == 200 && m_grpcHandler->payloadMode() == GrpcHandler::PayloadMode::BINARY) {
+            auto json = m_grpcHandler->renderJson(result.body);
+            if (json) {
+                result.body = std::move(*json);
+            }
+        }
         
         if (result.status_code != 200) {
             QString errorMsg = QString::fromStdString(result.error);
@@ -437,44 +506,36 @@ void RequestManager::executeGrpcRequest(const QString& requestBody) {
     emit loadingChanged();
 }
 
-void RequestManager::checkRequest() {
-    if (!m_currentRequest.valid()) {
-        m_isLoading = false;
-        emit loadingChanged();
+void RequestManager::completeRequest(quint64 requestId, std::exception_ptr error, RequestResult result) {
+    if (requestId != m_requestId) {
+        qDebug() << "Ignoring completion of superseded request" << requestId;
         return;
     }
 
-    auto status = m_currentRequest.wait_for(std::chrono::milliseconds(0));
-    if (status == std::future_status::ready) {
-        try {
-            RequestResult result = m_currentRequest.get();
-
-            qDebug() << "Request result:";
-            qDebug() << "- Status code:" << result.status_code;
-            qDebug() << "- Body:" << QString::fromStdString(result.body);
-            qDebug() << "- Error:" << QString::fromStdString(result.error);
-
-
-            // Convert to QVariantMap and emit signal
-            QVariantMap response = convertResultToVariantMap(result);
-            m_lastResponse = response;  // Store the last response
-            emit responseReceived(response);
+    try {
+        if (error) {
+            std::rethrow_exception(error);
+        }
 
-            qDebug() << "Request completed with status code:" << result.status_code;
-            qDebug() << "Response body:" << QString::fromStdString(result.body);
+        qDebug() << "Request result:";
+        qDebug() << "- Status code:" << result.status_code;
+        qDebug() << "- Body:" << QString::fromStdString(result.body);
+        qDebug() << "- Error:" << QString::fromStdString(result.error);
 
-        } catch (const std::exception& e) {
-            qDebug() << "Error getting request result:" << e.what();
-            emit errorOccurred(QString("Error: %1").arg(e.what()));
-        }
+        // Convert to QVariantMap and emit signal
+        QVariantMap response = convertResultToVariantMap(result);
+        m_lastResponse = response;  // Store the last response
+        emit responseReceived(response);
 
-        m_isLoading = false;
-        emit loadingChanged();
-    } else {
-        qDebug() << "Request not ready yet, checking again in 100ms";
+        qDebug() << "Request completed with status code:" << result.status_code;
 
-        QTimer::singleShot(CHECK_REQUEST_TIMEOUT, this, &RequestManager::checkRequest);
+    } catch (const std::exception& e) {
+        qDebug() << "Error getting request result:" << e.what();
+        emit errorOccurred(QString("Error: %1").arg(e.what()));
     }
+
+    m_isLoading = false;
+    emit loadingChanged();
 }
 
 void RequestManager::connectZMQ(const QString& endpoint, const QString& pattern, const QString& role) {
@@ -486,6 +547,9 @@ void RequestManager::connectZMQ(const QString& endpoint, const QString& pattern,
             throw Error(ErrorCode::INVALID_STATE, "ZMQ handler not initialized");
         }
 
+        // Set before configure() starts the poll thread that reads it
+        m_zmqShowsReceived = showsReceivedMessages(role);
+        m_zmqHandler->setSocketProfile(m_zmqProfile);
         m_zmqHandler->configure(zmqPattern, zmqRole, endpoint.toStdString());
         m_currentRole = role;
         
@@ -498,11 +562,358 @@ void RequestManager::connectZMQ(const QString& endpoint, const QString& pattern,
     }
 }
 
+void RequestManager::setZmqSocketProfile(const QVariantMap& options) {
+    try {
+        ZeroMQHandler::SocketProfile parsed = m_zmqProfile;
+        auto readInt = [&options](const char* key, int& value) {
+            if (options.contains(key)) {
+                value = options.value(key).toInt();
+            }
+        };
+        auto readBool = [&options](const char* key, bool& value) {
+            if (options.contains(key)) {
+                value = options.value(key).toBool();
+            }
+        };
+
+        readInt("ioThreads", parsed.io_threads);
+        if (parsed.io_threads <= 0) {
+            throw Error(ErrorCode::INVALID_CONFIG, "ZeroMQ I/O thread count must be greater than 0");
+        }
+        readInt("sendHwm", parsed.send_hwm);
+        readInt("receiveHwm", parsed.receive_hwm);
+        if (options.contains("affinity")) {
+            parsed.affinity = options.value("affinity").toULongLong();
+        }
+        readBool("immediate", parsed.immediate);
+        readInt("linger", parsed.linger);
+        readInt("tcpKeepalive", parsed.tcp_keepalive);
+        readInt("tcpKeepaliveIdle", parsed.tcp_keepalive_idle);
+        readInt("tcpKeepaliveInterval", parsed.tcp_keepalive_interval);
+        readInt("tcpKeepaliveCount", parsed.tcp_keepalive_count);
+        readInt("sendBuffer", parsed.send_buffer);
+        readInt("receiveBuffer", parsed.receive_buffer);
+        readBool("conflate", parsed.conflate);
+        readInt("receiveBatch", parsed.receive_batch);
+        if (parsed.receive_batch <= 0) {
+            throw Error(ErrorCode::INVALID_CONFIG, "ZeroMQ receive batch must be greater than 0");
+        }
+        readInt("timeout", parsed.timeout);
+
+        m_zmqProfile = parsed;
+        if (m_zmqHandler) {
+            m_zmqHandler->setSocketProfile(m_zmqProfile);
+        }
+    } catch (const Error& e) {
+        emit errorOccurred(QString::fromStdString(e.what()));
+    }
+}
+
+void RequestManager::addZmqSocket(const QVariantMap& spec) {
+    try {
+        if (!m_zmqHandler) {
+            throw Error(ErrorCode::INVALID_STATE, "ZMQ handler not initialized");
+        }
+
+        ZeroMQHandler::SocketSpec parsed;
+        parsed.name = spec.value("name").toString().toStdString();
+        parsed.role = convertZMQRole(spec.value("role").toString());
+        parsed.endpoint = spec.value("endpoint").toString().toStdString();
+        for (const auto& topic : spec.value("topics").toStringList()) {
+            parsed.topics.push_back(topic.toStdString());
+        }
+        m_zmqHandler->addSocket(parsed);
+    } catch (const std::exception& e) {
+        emit errorOccurred(QString::fromStdString(e.what()));
+    }
+}
+
+void RequestManager::removeZmqSocket(const QString& name) {
+    try {
+        if (m_zmqHandler) {
+            m_zmqHandler->removeSocket(name.toStdString());
+        }
+    } catch (const std::exception& e) {
+        emit errorOccurred(QString::fromStdString(e.what()));
+    }
+}
+
+bool RequestManager::sendOnZmqSocket(const QString& name, const QString& message) {
+    try {
+        if (!m_zmqHandler) {
+            throw Error(ErrorCode::INVALID_STATE, "ZMQ handler not initialized");
+        }
+        return m_zmqHandler->send(name.toStdString(), {Frame::fromString(message.toStdString())});
+    } catch (const std::exception& e) {
+        emit errorOccurred(QString::fromStdString(e.what()));
+        return false;
+    }
+}
+
+QVariantList RequestManager::zmqSocketMetrics() {
+    QVariantList sockets;
+    if (!m_zmqHandler) {
+        return sockets;
+    }
+
+    try {
+        for (const auto& metrics : m_zmqHandler->socketMetrics()) {
+            QVariantMap socket;
+            socket["name"] = QString::fromStdString(metrics.name);
+            socket["role"] = zmqRoleName(metrics.role);
+            socket["endpoint"] = QString::fromStdString(metrics.endpoint);
+            socket["messagesReceived"] = static_cast<qulonglong>(metrics.messagesReceived);
+            socket["messagesSent"] = static_cast<qulonglong>(metrics.messagesSent);
+            socket["bytesReceived"] = static_cast<qulonglong>(metrics.bytesReceived);
+            socket["bytesSent"] = static_cast<qulonglong>(metrics.bytesSent);
+            sockets.append(socket);
+        }
+    } catch (const std::exception& e) {
+        emit errorOccurred(QString::fromStdString(e.what()));
+    }
+    return sockets;
+}
+
+void RequestManager::startZmqCapture(const QString& path) {
+    try {
+        if (!m_zmqHandler) {
+            throw Error(ErrorCode::INVALID_STATE, "ZMQ handler not initialized");
+        }
+        m_zmqHandler->startCapture(path.toStdString());
+    } catch (const std::exception& e) {
+        emit errorOccurred(QString::fromStdString(e.what()));
+    }
+}
+
+void RequestManager::stopZmqCapture() {
+    if (m_zmqHandler) {
+        m_zmqHandler->stopCapture();
+    }
+}
+
+void RequestManager::replayZmqCapture(const QString& path, const QVariantMap& options) {
+    ZeroMQHandler::ReplayOptions parsed;
+    try {
+        if (!m_zmqHandler) {
+            throw Error(ErrorCode::INVALID_STATE, "ZMQ handler not initialized");
+        }
+        if (m_zmqReplay.valid() &&
+            m_zmqReplay.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            throw Error(ErrorCode::INVALID_STATE, "A replay is already running");
+        }
+        if (options.contains("pacing")) {
+            parsed.pacing = convertReplayPacing(options.value("pacing").toString());
+        }
+        if (options.contains("speed")) {
+            parsed.speed = options.value("speed").toDouble();
+        }
+    } catch (const Error& e) {
+        emit errorOccurred(QString::fromStdString(e.what()));
+        return;
+    }
+
+    // Replay sleeps through the captured gaps, keep it off the GUI thread
+    QPointer<RequestManager> self(this);
+    m_zmqReplay = Executor::instance().submit(
+        [handler = m_zmqHandler.get(), path = path.toStdString(), parsed, self]() {
+            QVariantMap stats;
+            QString error;
+            try {
+                auto replayed = handler->replay(path, parsed);
+                stats["messages"] = static_cast<qulonglong>(replayed.messages);
+                stats["failed"] = static_cast<qulonglong>(replayed.failed);
+                stats["bytes"] = static_cast<qulonglong>(replayed.bytes);
+                stats["durationUs"] = toMicroseconds(replayed.duration);
+                stats["maxLagUs"] = toMicroseconds(replayed.max_lag);
+            } catch (const std::exception& e) {
+                error = QString::fromStdString(e.what());
+            }
+            // qApp outlives the manager, self is only looked at on the GUI thread
+            QMetaObject::invokeMethod(qApp, [self, stats, error]() {
+                if (!self) {
+                    return;
+                }
+                if (error.isEmpty()) {
+                    emit self->zmqReplayFinished(stats);
+                } else {
+                    emit self->errorOccurred(error);
+                }
+            }, Qt::QueuedConnection);
+        });
+}
+
+void RequestManager::stopZmqReplay() {
+    if (m_zmqHandler) {
+        m_zmqHandler->stopReplay();
+    }
+}
+
+void RequestManager::runZmqBenchmark(const QVariantMap& options) {
+    testing::ZmqBenchmarkConfig config;
+    try {
+        if (m_zmqBenchmarkRun.valid() &&
+            m_zmqBenchmarkRun.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            throw Error(ErrorCode::INVALID_STATE, "A ZeroMQ benchmark is already running");
+        }
+
+        config.profile = m_zmqProfile;
+        if (options.contains("pattern")) {
+            config.pattern = convertPattern(options.value("pattern").toString());
+        }
+        if (options.contains("mode")) {
+            config.mode = convertBenchmarkMode(options.value("mode").toString());
+        }
+        if (options.contains("endpoint")) {
+            config.endpoint = options.value("endpoint").toString().toStdString();
+        }
+        if (options.contains("messageSize")) {
+            config.message_size = static_cast<std::size_t>(options.value("messageSize").toLongLong());
+        }
+        if (options.contains("messageCount")) {
+            config.message_count = static_cast<std::size_t>(options.value("messageCount").toLongLong());
+        }
+        if (options.contains("receiveTimeoutMs")) {
+            config.receive_timeout = std::chrono::milliseconds(options.value("receiveTimeoutMs").toLongLong());
+        }
+    } catch (const Error& e) {
+        emit errorOccurred(QString::fromStdString(e.what()));
+        return;
+    }
+
+    // The benchmark blocks for the whole run, keep it off the GUI thread
+    QPointer<RequestManager> self(this);
+    m_zmqBenchmarkRun = Executor::instance().submit([benchmark = &m_zmqBenchmark, config, self]() {
+        QVariantMap result;
+        QString error;
+        try {
+            auto measured = benchmark->run(config);
+            result["messagesSent"] = static_cast<qulonglong>(measured.messages_sent);
+            result["messagesReceived"] = static_cast<qulonglong>(measured.messages_received);
+            result["messagesLost"] = static_cast<qulonglong>(measured.messages_lost);
+            result["messagesReordered"] = static_cast<qulonglong>(measured.messages_reordered);
+            result["messagesPerSecond"] = measured.messages_per_second;
+            result["bytesPerSecond"] = measured.bytes_per_second;
+            result["oneWay"] = histogramToVariantMap(measured.one_way);
+            result["roundTrip"] = histogramToVariantMap(measured.round_trip);
+        } catch (const std::exception& e) {
+            error = QString::fromStdString(e.what());
+        }
+        // qApp outlives the manager, self is only looked at on the GUI thread
+        QMetaObject::invokeMethod(qApp, [self, result, error]() {
+            if (!self) {
+                return;
+            }
+            if (error.isEmpty()) {
+                emit self->zmqBenchmarkFinished(result);
+            } else {
+                emit self->errorOccurred(error);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void RequestManager::stopZmqBenchmark() {
+    m_zmqBenchmark.stop();
+}
+
+void RequestManager::finishZmqBenchmark() {
+    // The running task uses m_zmqBenchmark; a stop() just before run() starts would be missed
+    if (m_zmqBenchmarkRun.valid()) {
+        do {
+            m_zmqBenchmark.stop();
+        } while (m_zmqBenchmarkRun.wait_for(std::chrono::milliseconds(50)) != std::future_status::ready);
+        m_zmqBenchmarkRun = {};
+    }
+}
+
+void RequestManager::startZmqProxy(const QVariantMap& options) {
+    try {
+        if (m_zmqProxy && m_zmqProxy->state() != ZmqProxy::State::STOPPED) {
+            throw Error(ErrorCode::INVALID_STATE, "ZeroMQ proxy is already running");
+        }
+
+        ZmqProxy::Config config;
+        config.profile = m_zmqProfile;
+        if (options.contains("kind")) {
+            config.kind = convertProxyKind(options.value("kind").toString());
+        }
+        if (options.contains("frontend")) {
+            config.frontend = options.value("frontend").toString().toStdString();
+        }
+        if (options.contains("backend")) {
+            config.backend = options.value("backend").toString().toStdString();
+        }
+        if (options.contains("capturePath")) {
+            config.capture_path = options.value("capturePath").toString().toStdString();
+        }
+
+        auto proxy = std::make_unique<ZmqProxy>(std::move(config));
+        proxy->start();
+        m_zmqProxy = std::move(proxy);
+        emit zmqProxyStateChanged("RUNNING");
+    } catch (const std::exception& e) {
+        emit errorOccurred(QString::fromStdString(e.what()));
+    }
+}
+
+void RequestManager::pauseZmqProxy() {
+    if (m_zmqProxy && m_zmqProxy->state() == ZmqProxy::State::RUNNING) {
+        m_zmqProxy->pause();
+        emit zmqProxyStateChanged("PAUSED");
+    }
+}
+
+void RequestManager::resumeZmqProxy() {
+    if (m_zmqProxy && m_zmqProxy->state() == ZmqProxy::State::PAUSED) {
+        m_zmqProxy->resume();
+        emit zmqProxyStateChanged("RUNNING");
+    }
+}
+
+void RequestManager::stopZmqProxy() {
+    // The proxy is kept so its final counters stay available
+    if (m_zmqProxy && m_zmqProxy->state() != ZmqProxy::State::STOPPED) {
+        m_zmqProxy->terminate();
+        emit zmqProxyStateChanged("STOPPED");
+    }
+}
+
+QVariantMap RequestManager::zmqProxyStats() {
+    QVariantMap stats;
+    if (!m_zmqProxy) {
+        return stats;
+    }
+
+    auto current = m_zmqProxy->stats();
+    stats["frontendToBackendMessages"] = static_cast<qulonglong>(current.frontend_to_backend.messages);
+    stats["frontendToBackendBytes"] = static_cast<qulonglong>(current.frontend_to_backend.bytes);
+    stats["backendToFrontendMessages"] = static_cast<qulonglong>(current.backend_to_frontend.messages);
+    stats["backendToFrontendBytes"] = static_cast<qulonglong>(current.backend_to_frontend.bytes);
+    stats["captured"] = static_cast<qulonglong>(current.captured);
+    stats["recorded"] = static_cast<qulonglong>(current.recorded);
+    stats["roundTrips"] = static_cast<qulonglong>(current.round_trips);
+    stats["roundTripMinUs"] = toMicroseconds(current.round_trip_min);
+    stats["roundTripMeanUs"] = toMicroseconds(current.round_trip_mean);
+    stats["roundTripMaxUs"] = toMicroseconds(current.round_trip_max);
+    stats["elapsedUs"] = toMicroseconds(current.elapsed);
+    return stats;
+}
+
+void RequestManager::createGrpcHandler() {
+    m_grpcHandler = std::make_unique<GrpcHandler>();
+    m_grpcHandler->setChannelOptions(m_grpcChannelOptions);
+    m_handler = m_grpcHandler.get();
+
+    // Streamed messages arrive on completion queue threads, the model batches them for the UI
+    connect(m_grpcHandler.get(), &GrpcHandler::streamMessageReceived, this,
+            [this](const QString& message) { m_messages->post("Received", message); },
+            Qt::DirectConnection);
+}
+
 void RequestManager::loadGrpcProtoFile(const QString& path) {
     try {
         if (!m_grpcHandler) {
-            m_grpcHandler = std::make_unique<GrpcHandler>();
-            m_handler = m_grpcHandler.get();
+            createGrpcHandler();
         }
         
         m_grpcHandler->loadProtoFile(path.toStdString());
@@ -531,6 +942,68 @@ void RequestManager::loadGrpcProtoFile(const QString& path) {
     }
 }
 
+void RequestManager::discoverGrpcServices() {
+    GrpcHandler::DiscoveryTask task;
+    try {
+        if (!m_grpcHandler) {
+            createGrpcHandler();
+        }
+        m_grpcHandler->setEndpoint(m_grpcEndpoint.toStdString());
+        task = m_grpcHandler->prepareDiscovery();
+    } catch (const std::exception& e) {
+        emit errorOccurred(QString::fromStdString(e.what()));
+        return;
+    }
+
+    // Reflection waits on the server, keep it off the GUI thread and hop back with the result
+    const auto discoveryId = ++m_discoveryId;
+    QPointer<RequestManager> self(this);
+    Executor::instance().post([task = std::move(task), self, discoveryId]() mutable {
+        auto discovery = std::make_shared<Expected<GrpcHandler::Discovery>>(
+            [&task]() -> Expected<GrpcHandler::Discovery> {
+                try {
+                    return task();
+                } catch (const Error& e) {
+                    return makeError(e.code(), e.what());
+                } catch (const std::exception& e) {
+                    // Protobuf and gRPC failures must not escape into the pool
+                    return makeError(ErrorCode::UNKNOWN, std::string("Service discovery failed: ") + e.what());
+                }
+            }());
+        // qApp outlives the manager, self is only looked at on the GUI thread
+        QMetaObject::invokeMethod(qApp, [self, discoveryId, discovery]() {
+            if (self) {
+                self->completeDiscovery(discoveryId, std::move(*discovery));
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void RequestManager::completeDiscovery(quint64 discoveryId, Expected<GrpcHandler::Discovery> discovery) {
+    if (discoveryId != m_discoveryId || !m_grpcHandler) {
+        return;
+    }
+    if (!discovery) {
+        emit errorOccurred(QString::fromStdString(discovery.error().what()));
+        return;
+    }
+
+    try {
+        m_grpcServices = m_grpcHandler->adoptDiscovery(std::move(*discovery));
+
+        // Methods are only known once a service's descriptors are fetched, the first one's came along
+        m_grpcServiceMethods.clear();
+        m_currentGrpcService.clear();
+        if (!m_grpcServices.isEmpty()) {
+            setGrpcService(m_grpcServices.first());
+        }
+
+        emit grpcServicesChanged();
+    } catch (const std::exception& e) {
+        emit errorOccurred(QString::fromStdString(e.what()));
+    }
+}
+
 QStringList RequestManager::getGrpcMethods(const QString& service) {
     QStringList methods = m_grpcServiceMethods.value(service, QStringList());
     qDebug() << "Getting methods for service:" << service << "found:" << methods;
@@ -539,19 +1012,72 @@ QStringList RequestManager::getGrpcMethods(const QString& service) {
 
 void RequestManager::setGrpcService(const QString& service) {
     qDebug() << "Setting gRPC service to:" << service;
-    if (m_currentGrpcService != service) {
-        m_currentGrpcService = service;
-        if (m_grpcHandler) {
-            try {
-                m_grpcHandler->setService(service.toStdString());
-                QStringList methods = m_grpcHandler->getServiceMethods(service.toStdString());
-                m_grpcServiceMethods[service] = methods;
-                qDebug() << "Updated methods for service" << service << ":" << methods;
-            } catch (const Error& e) {
-                emit errorOccurred(QString::fromStdString(e.what()));
-            }
+    if (m_currentGrpcService == service) {
+        return;
+    }
+    m_currentGrpcService = service;
+    if (!m_grpcHandler) {
+        return;
+    }
+
+    GrpcHandler::ServiceFetchTask task;
+    try {
+        task = m_grpcHandler->prepareServiceFetch(service.toStdString());
+        if (!task) {
+            m_grpcHandler->setService(service.toStdString());
+            updateGrpcMethods(service);
+            return;
         }
+    } catch (const Error& e) {
+        emit errorOccurred(QString::fromStdString(e.what()));
+        return;
+    }
+
+    // A discovered service's descriptors come from the server, fetch them the way discovery runs
+    const auto fetchId = ++m_serviceFetchId;
+    QPointer<RequestManager> self(this);
+    Executor::instance().post([task = std::move(task), self, fetchId]() mutable {
+        auto fetch = std::make_shared<Expected<GrpcHandler::ServiceFetch>>(
+            [&task]() -> Expected<GrpcHandler::ServiceFetch> {
+                try {
+                    return task();
+                } catch (const Error& e) {
+                    return makeError(e.code(), e.what());
+                } catch (const std::exception& e) {
+                    return makeError(ErrorCode::UNKNOWN, std::string("Fetching service descriptors failed: ") + e.what());
+                }
+            }());
+        QMetaObject::invokeMethod(qApp, [self, fetchId, fetch]() {
+            if (self) {
+                self->completeServiceFetch(fetchId, std::move(*fetch));
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void RequestManager::completeServiceFetch(quint64 fetchId, Expected<GrpcHandler::ServiceFetch> fetch) {
+    if (fetchId != m_serviceFetchId || !m_grpcHandler) {
+        return;
     }
+    if (!fetch) {
+        emit errorOccurred(QString::fromStdString(fetch.error().what()));
+        return;
+    }
+
+    try {
+        const auto service = QString::fromStdString(fetch->service);
+        m_grpcHandler->adoptService(std::move(*fetch));
+        updateGrpcMethods(service);
+    } catch (const std::exception& e) {
+        emit errorOccurred(QString::fromStdString(e.what()));
+    }
+}
+
+void RequestManager::updateGrpcMethods(const QString& service) {
+    QStringList methods = m_grpcHandler->getServiceMethods(service.toStdString());
+    m_grpcServiceMethods[service] = methods;
+    qDebug() << "Updated methods for service" << service << ":" << methods;
+    emit grpcMethodsChanged(service, methods);
 }
 
 void RequestManager::setGrpcMethod(const QString& method) {
@@ -587,6 +1113,41 @@ void RequestManager::setGrpcUseSSL(bool use) {
     }
 }
 
+void RequestManager::setGrpcChannelOptions(const QVariantMap& options) {
+    try {
+        ChannelPool::Options parsed = m_grpcChannelOptions;
+        if (options.contains("channels")) {
+            int channels = options.value("channels").toInt();
+            if (channels <= 0) {
+                throw Error(ErrorCode::INVALID_CONFIG, "gRPC channel count must be greater than 0");
+            }
+            parsed.channels = static_cast<std::size_t>(channels);
+        }
+        if (options.contains("loadBalancing")) {
+            parsed.load_balancing = convertLoadBalancing(options.value("loadBalancing").toString());
+        }
+        if (options.contains("keepaliveMs")) {
+            parsed.keepalive_time = std::chrono::milliseconds(options.value("keepaliveMs").toLongLong());
+        }
+        if (options.contains("keepaliveTimeoutMs")) {
+            parsed.keepalive_timeout = std::chrono::milliseconds(options.value("keepaliveTimeoutMs").toLongLong());
+        }
+        if (options.contains("keepaliveWithoutCalls")) {
+            parsed.keepalive_without_calls = options.value("keepaliveWithoutCalls").toBool();
+        }
+        if (options.contains("compression")) {
+            parsed.compression = convertCompression(options.value("compression").toString());
+        }
+
+        m_grpcChannelOptions = std::move(parsed);
+        if (m_grpcHandler) {
+            m_grpcHandler->setChannelOptions(m_grpcChannelOptions);
+        }
+    } catch (const Error& e) {
+        emit errorOccurred(QString::fromStdString(e.what()));
+    }
+}
+
 void RequestManager::setProtoFilePath(const QString& path) {
     if (m_protoFilePath != path) {
         m_protoFilePath = path;
@@ -601,6 +1162,32 @@ void RequestManager::setProtoFilePath(const QString& path) {
     }
 }
 
+void RequestManager::setHttpCacheEnabled(bool enabled) {
+    if (m_httpCacheEnabled != enabled) {
+        m_httpCacheEnabled = enabled;
+        if (m_restHandler) {
+            m_restHandler->setCache(enabled ? m_httpCache : nullptr);
+        }
+        emit httpCacheChanged();
+    }
+}
+
+void RequestManager::setHttpCacheDirectory(const QString& directory) {
+    if (m_httpCacheDirectory != directory) {
+        m_httpCacheDirectory = directory;
+
+        HttpCache::Options options;
+        if (!directory.isEmpty()) {
+            options.disk_directory = std::filesystem::path(directory.toStdString());
+        }
+        m_httpCache = std::make_shared<HttpCache>(std::move(options));
+        if (m_restHandler && m_httpCacheEnabled) {
+            m_restHandler->setCache(m_httpCache);
+        }
+        emit httpCacheChanged();
+    }
+}
+
 void RequestManager::exportResponse(const QString& format) {
     if (!m_lastResponse.contains("body") || m_lastResponse["body"].toString().isEmpty()) {
         emit errorOccurred("No response to export");
@@ -678,6 +1265,7 @@ Q_INVOKABLE void RequestManager::saveResponseToFile(const QString& filePath, con
 }
 
 void RequestManager::clearMessages() {
+    m_messages->clear();
     emit messagesCleared();
 }
 
@@ -13,12 +13,13 @@ ResponseModel::ResponseModel(QObject* parent)
 {
 }
 
+namespace {
+    // Reformatting reparses the whole document; larger bodies are shown as received
+    constexpr qsizetype kMaxFormattedBody = 256 * 1024;
+}
+
 QString ResponseModel::getFormattedBody() const {
-    // Try to format as JSON if possible
-    if (m_body.startsWith('{') || m_body.startsWith('[')) {
-        return formatJson(m_body);
-    }
-    return m_body;
+    return m_formattedBody;
 }
 
 QString ResponseModel::getTime() const {
@@ -31,6 +32,8 @@ QString ResponseModel::getTime() const {
 void ResponseModel::updateResponse(const QVariantMap& response) {
     m_statusCode = response["status_code"].toInt();
     m_body = response["body"].toString();
+    // Formatted once here, the view reads formattedBody on every repaint
+    m_formattedBody = formatJson(m_body);
     m_headers = response["headers"].toList();
     m_error = response["error"].toString();
     
@@ -43,6 +46,7 @@ void ResponseModel::updateResponse(const QVariantMap& response) {
 
 void ResponseModel::clear() {
     m_body.clear();
+    m_formattedBody.clear();
     m_statusCode = 0;
     m_headers.clear();
     m_cookies.clear();
@@ -83,6 +87,10 @@ void ResponseModel::parseCookies(const std::vector<Header>& headers) {
 }
 
 QString ResponseModel::formatJson(const QString& json) const {
+    // Try to format as JSON if possible
+    if (!(json.startsWith('{') || json.startsWith('[')) || json.size() > kMaxFormattedBody) {
+        return json;
+    }
     try {
         return QString::fromStdString(json::parse(json.toStdString()).dump(2));
     } catch ([[__maybe_unused__]]const json::parse_error& jsn) {
@@ -1,13 +1,59 @@
 #include "testing/benchmark_engine.hpp"
 #include "core/error.hpp"
+#include "core/executor.hpp"
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/use_future.hpp>
 #include <thread>
 #include <vector>
 #include <atomic>
 
 namespace flowdriver::testing {
 
+namespace {
+    /**
+     * @brief Applies a benchmark's gRPC settings and restores the handler's own when done
+     */
+    class GrpcSettingsScope {
+    public:
+        GrpcSettingsScope(ProtocolHandler* handler, const GrpcBenchmarkOptions& options)
+            : handler_(dynamic_cast<GrpcHandler*>(handler))
+        {
+            if (!handler_) {
+                return;
+            }
+            mode_ = handler_->payloadMode();
+            assertions_ = handler_->responseAssertions();
+            handler_->setPayloadMode(options.payload_mode);
+            handler_->setResponseAssertions(options.assertions);
+            if (options.channel) {
+                channel_ = handler_->channelOptions();
+                handler_->setChannelOptions(*options.channel);
+            }
+        }
+
+        ~GrpcSettingsScope() {
+            if (handler_) {
+                handler_->setPayloadMode(mode_);
+                handler_->setResponseAssertions(std::move(assertions_));
+                if (channel_) {
+                    handler_->setChannelOptions(std::move(*channel_));
+                }
+            }
+        }
+
+        GrpcSettingsScope(const GrpcSettingsScope&) = delete;
+        GrpcSettingsScope& operator=(const GrpcSettingsScope&) = delete;
+
+    private:
+        GrpcHandler* handler_;
+        GrpcHandler::PayloadMode mode_{GrpcHandler::PayloadMode::JSON};
+        std::vector<GrpcHandler::FieldAssertion> assertions_;
+        std::optional<ChannelPool::Options> channel_;
+    };
+}
+
 BenchmarkEngine::BenchmarkEngine(ProtocolHandler* handler)
-    : m_handler(handler)
+    : handler_(handler)
 {
 }
 
@@ -21,26 +67,54 @@ BenchmarkResult BenchmarkEngine::run(const BenchmarkConfig& config) {
     BenchmarkResult result;
     result.start_time = std::chrono::system_clock::now();
     
-    std::vector<std::thread> threads;
-    std::atomic<size_t> success_count{0};
-    std::atomic<size_t> error_count{0};
+    Counters counters;
+    GrpcSettingsScope grpc_settings(handler_, config.grpc);
+    
+    RequestConfig request = config.request;
+    if (config.cache_mode == CacheMode::COLD) {
+        request.bypass_cache = true;
+    } else {
+        // Prime the cache outside of the measured window, failures show up again in the measured run
+        handler_->tryExecute(request);
+    }
     
     is_running_ = true;
     
+    if (config.execution_mode == ExecutionMode::COROUTINES) {
+        runCoroutines(config, request, counters);
+    } else {
+        runThreads(config, request, counters);
+    }
+    
+    result.end_time = std::chrono::system_clock::now();
+    result.successful_requests = counters.success;
+    result.failed_requests = counters.errors;
+    result.total_requests = result.successful_requests + result.failed_requests;
+    result.cache_hits = counters.cache_hits;
+    result.stream_messages = counters.stream_messages;
+    
+    auto duration = std::chrono::duration_cast<std::chrono::seconds>(
+        result.end_time - result.start_time).count();
+    
+    result.requests_per_second = static_cast<double>(result.total_requests) / duration;
+    
+    return result;
+}
+
+void BenchmarkEngine::runThreads(const BenchmarkConfig& config, const RequestConfig& request,
+                                 Counters& counters) {
+    std::vector<std::thread> threads;
+    
     // Create worker threads
     for (int i = 0; i < config.concurrent_users; ++i) {
-        threads.emplace_back([this, &config, &success_count, &error_count]() {
+        threads.emplace_back([this, &request, &counters]() {
+            // Responses are only inspected for their status, keep them in a per-worker arena
+            ResponseArena arena;
             while (is_running_) {
-                try {
-                    auto req_result = m_handler->execute(config.request);
-                    if (req_result.status_code >= 200 && req_result.status_code < 300) {
-                        ++success_count;
-                    } else {
-                        ++error_count;
-                    }
-                } catch (const Error& e) {
-                    ++error_count;
-                }
+                auto result = handler_->tryExecuteRaw(request, arena);
+                record(result ? Outcome{result->status_code, result->cache_status, result->metrics.messages_received}
+                      : Outcome{}, counters);
+                arena.reset();
             }
         });
     }
@@ -53,22 +127,51 @@ BenchmarkResult BenchmarkEngine::run(const BenchmarkConfig& config) {
             thread.join();
         }
     }
+}
+
+void BenchmarkEngine::runCoroutines(const BenchmarkConfig& config, const RequestConfig& request,
+                                    Counters& counters) {
+    std::vector<std::future<void>> users;
+    users.reserve(config.concurrent_users);
     
-    result.end_time = std::chrono::system_clock::now();
-    result.total_requests = success_count + error_count;
-    result.successful_requests = success_count;
-    result.failed_requests = error_count;
-    
-    auto duration = std::chrono::duration_cast<std::chrono::seconds>(
-        result.end_time - result.start_time).count();
+    // Spread users over the I/O pool, each one is a coroutine rather than a thread
+    for (int i = 0; i < config.concurrent_users; ++i) {
+        users.push_back(boost::asio::co_spawn(Executor::instance().ioContext(),
+                                              runUser(request, counters),
+                                              boost::asio::use_future));
+    }
     
-    result.requests_per_second = static_cast<double>(result.total_requests) / duration;
+    std::this_thread::sleep_for(config.duration);
+    stop();
     
-    return result;
+    for (auto& user : users) {
+        user.get();
+    }
+}
+
+boost::asio::awaitable<void> BenchmarkEngine::runUser(const RequestConfig& request, Counters& counters) {
+    while (is_running_) {
+        auto result = co_await handler_->co_tryExecute(request);
+        record(result ? Outcome{result->status_code, result->cache_status, result->metrics.messages_received}
+                      : Outcome{}, counters);
+    }
+}
+
+void BenchmarkEngine::record(const Outcome& outcome, Counters& counters) {
+    counters.stream_messages += outcome.stream_messages;
+    if (outcome.status_code >= 200 && outcome.status_code < 300) {
+        ++counters.success;
+        if (outcome.cache_status == CacheStatus::HIT ||
+            outcome.cache_status == CacheStatus::REVALIDATED) {
+            ++counters.cache_hits;
+        }
+    } else {
+        ++counters.errors;
+    }
 }
 
 std::future<BenchmarkResult> BenchmarkEngine::runAsync(const BenchmarkConfig& config) {
-    return std::async(std::launch::async, [this, config]() {
+    return Executor::instance().submit([this, config]() {
         return run(config);
     });
 }
@@ -89,6 +192,14 @@ void BenchmarkEngine::validateConfig(const BenchmarkConfig& config) {
     if (config.request.url.empty()) {
         throw Error(ErrorCode::INVALID_CONFIG, "Request URL cannot be empty");
     }
+
+    if (!config.grpc.assertions.empty() && config.grpc.payload_mode != GrpcHandler::PayloadMode::BINARY) {
+        throw Error(ErrorCode::INVALID_CONFIG, "Response assertions need the BINARY payload mode");
+    }
+
+    if (config.grpc.channel && config.grpc.channel->channels == 0) {
+        throw Error(ErrorCode::INVALID_CONFIG, "gRPC channel count must be greater than 0");
+    }
 }
 
 } // namespace flowdriver::testing 
\ No newline at end of file
@@ -0,0 +1,412 @@
+#include "testing/zmq_benchmark.hpp"
+#include "core/error.hpp"
+#include "core/executor.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <thread>
+#include <QDebug>
+
+namespace flowdriver::testing {
+
+namespace {
+    // Leads every benchmark message, the rest of it is padding
+    struct Stamp {
+        std::uint64_t sequence;
+        std::int64_t sent_ns;    // Steady clock at the sender
+        std::int64_t echoed_ns;  // Steady clock at the replier, round trip patterns only
+    };
+
+    // Sequence of the messages exchanged before measuring
+    constexpr std::uint64_t kProbe = std::numeric_limits<std::uint64_t>::max();
+
+    constexpr std::chrono::seconds kConnectTimeout{5};
+    constexpr std::chrono::milliseconds kProbeInterval{10};
+
+    std::int64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    std::optional<Stamp> readStamp(const zmq::message_t& message) {
+        if (message.size() < sizeof(Stamp)) {
+            return std::nullopt;
+        }
+        Stamp stamp;
+        std::memcpy(&stamp, message.data(), sizeof(Stamp));
+        return stamp;
+    }
+
+    bool isLocalEndpoint(const std::string& endpoint) {
+        return endpoint.starts_with("tcp://127.0.0.1:") || endpoint.starts_with("tcp://localhost:") ||
+               endpoint.starts_with("ipc://") || endpoint.starts_with("inproc://");
+    }
+}
+
+void LatencyHistogram::record(std::chrono::nanoseconds latency) {
+    latency = std::max(latency, std::chrono::nanoseconds(0));
+    ++counts_[bucketIndex(static_cast<std::uint64_t>(latency.count()))];
+    ++count_;
+    min_ = std::min(min_, latency);
+    max_ = std::max(max_, latency);
+    total_ += latency;
+}
+
+std::chrono::nanoseconds LatencyHistogram::min() const {
+    return count_ ? min_ : std::chrono::nanoseconds(0);
+}
+
+std::chrono::nanoseconds LatencyHistogram::mean() const {
+    return count_ ? total_ / static_cast<std::int64_t>(count_) : std::chrono::nanoseconds(0);
+}
+
+std::chrono::nanoseconds LatencyHistogram::percentile(double percentile) const {
+    if (count_ == 0) {
+        return std::chrono::nanoseconds(0);
+    }
+    auto target = static_cast<std::size_t>(std::ceil(std::clamp(percentile, 0.0, 100.0) / 100.0 * count_));
+    target = std::max<std::size_t>(target, 1);
+
+    std::size_t seen = 0;
+    for (std::size_t i = 0; i < kBucketCount; ++i) {
+        seen += counts_[i];
+        if (seen >= target) {
+            return std::min(std::chrono::nanoseconds(bucketUpper(i)), max_);
+        }
+    }
+    return max_;
+}
+
+std::vector<LatencyHistogram::Bucket> LatencyHistogram::buckets() const {
+    std::vector<Bucket> buckets;
+    for (std::size_t i = 0; i < kBucketCount; ++i) {
+        if (counts_[i] > 0) {
+            buckets.push_back({std::chrono::nanoseconds(bucketUpper(i)), counts_[i]});
+        }
+    }
+    return buckets;
+}
+
+// Values below 8 get a bucket each, above that every power of two is split in 8
+std::size_t LatencyHistogram::bucketIndex(std::uint64_t nanoseconds) {
+    constexpr std::uint64_t kSubBuckets = 1 << kSubBucketBits;
+    if (nanoseconds < kSubBuckets) {
+        return nanoseconds;
+    }
+    auto exponent = std::bit_width(nanoseconds) - 1;
+    auto mantissa = (nanoseconds >> (exponent - kSubBucketBits)) & (kSubBuckets - 1);
+    return (exponent - kSubBucketBits + 1) * kSubBuckets + mantissa;
+}
+
+std::uint64_t LatencyHistogram::bucketUpper(std::size_t index) {
+    constexpr std::uint64_t kSubBuckets = 1 << kSubBucketBits;
+    if (index < kSubBuckets) {
+        return index;
+    }
+    auto shift = index / kSubBuckets - 1;
+    auto mantissa = index % kSubBuckets;
+    return ((kSubBuckets + mantissa) << shift) + ((std::uint64_t{1} << shift) - 1);
+}
+
+/**
+ * @brief Both ends of the benchmarked connection
+ */
+struct ZmqBenchmark::Sockets {
+    explicit Sockets(const ZmqBenchmarkConfig& config);
+
+    bool send(std::uint64_t sequence);
+    bool receive(zmq::message_t& identity, zmq::message_t& message);
+    bool echo(zmq::message_t& identity, zmq::message_t& message);
+
+    const ZmqBenchmarkConfig& config;
+    zmq::context_t context;
+    zmq::socket_t sender;
+    zmq::socket_t receiver;
+    std::vector<char> payload;
+    bool round_trip{false};  // Receiver replies to every message
+    bool routed{false};      // Receiver is a ROUTER, messages carry an identity frame
+};
+
+ZmqBenchmark::Sockets::Sockets(const ZmqBenchmarkConfig& config)
+    : config(config)
+    , context(std::max(config.profile.io_threads, 1))
+    , payload(config.message_size, 'x')
+{
+    zmq::socket_type send_type{};
+    zmq::socket_type receive_type{};
+    switch (config.pattern) {
+    case ZeroMQHandler::Pattern::REQ_REP:
+        send_type = zmq::socket_type::req;
+        receive_type = zmq::socket_type::rep;
+        round_trip = true;
+        break;
+    case ZeroMQHandler::Pattern::PUB_SUB:
+        send_type = zmq::socket_type::pub;
+        receive_type = zmq::socket_type::sub;
+        break;
+    case ZeroMQHandler::Pattern::PUSH_PULL:
+        send_type = zmq::socket_type::push;
+        receive_type = zmq::socket_type::pull;
+        break;
+    case ZeroMQHandler::Pattern::DEALER_ROUTER:
+        send_type = zmq::socket_type::dealer;
+        receive_type = zmq::socket_type::router;
+        round_trip = config.mode == ZmqBenchmarkMode::LATENCY;
+        routed = true;
+        break;
+    }
+
+    sender = zmq::socket_t(context, send_type);
+    receiver = zmq::socket_t(context, receive_type);
+    for (auto* socket : {&sender, &receiver}) {
+        ZeroMQHandler::applyProfile(*socket, config.profile);
+        socket->set(zmq::sockopt::rcvtimeo, static_cast<int>(config.receive_timeout.count()));
+        socket->set(zmq::sockopt::sndtimeo, static_cast<int>(config.receive_timeout.count()));
+    }
+    if (receive_type == zmq::socket_type::sub) {
+        receiver.set(zmq::sockopt::subscribe, "");
+    }
+
+    // Inproc needs the bind first
+    receiver.bind(config.endpoint);
+    sender.connect(config.endpoint);
+}
+
+bool ZmqBenchmark::Sockets::send(std::uint64_t sequence) {
+    Stamp stamp{sequence, nowNs(), 0};
+    std::memcpy(payload.data(), &stamp, sizeof(Stamp));
+    return sender.send(zmq::buffer(payload.data(), payload.size())).has_value();
+}
+
+bool ZmqBenchmark::Sockets::receive(zmq::message_t& identity, zmq::message_t& message) {
+    if (routed && !receiver.recv(identity)) {
+        return false;
+    }
+    return receiver.recv(message).has_value();
+}
+
+// Sends the received message back with the receipt time filled in
+bool ZmqBenchmark::Sockets::echo(zmq::message_t& identity, zmq::message_t& message) {
+    if (message.size() >= sizeof(Stamp)) {
+        auto echoed = nowNs();
+        std::memcpy(static_cast<char*>(message.data()) + offsetof(Stamp, echoed_ns), &echoed, sizeof(echoed));
+    }
+    if (routed && !receiver.send(identity, zmq::send_flags::sndmore)) {
+        return false;
+    }
+    return receiver.send(message, zmq::send_flags::none).has_value();
+}
+
+ZmqBenchmark::~ZmqBenchmark() {
+    stop();
+}
+
+ZmqBenchmarkResult ZmqBenchmark::run(const ZmqBenchmarkConfig& config) {
+    validateConfig(config);
+
+    ZmqBenchmarkResult result;
+    result.profile = config.profile;
+
+    // Cleared on every way out, so stop() and the next run see an idle benchmark
+    struct RunningScope {
+        std::atomic<bool>& running;
+        ~RunningScope() { running = false; }
+    } running_scope{is_running_};
+    is_running_ = true;
+
+    try {
+        Sockets sockets(config);
+        if (!warmUp(sockets)) {
+            qDebug() << "ZeroMQ benchmark stopped before the sockets connected";
+            return result;
+        }
+
+        result.start_time = std::chrono::system_clock::now();
+        if (config.mode == ZmqBenchmarkMode::LATENCY || config.pattern == ZeroMQHandler::Pattern::REQ_REP) {
+            runLatency(sockets, result);
+        } else {
+            runThroughput(sockets, result);
+        }
+        result.end_time = std::chrono::system_clock::now();
+    } catch (const zmq::error_t& e) {
+        throw Error(ErrorCode::ZMQ_ERROR, std::string("ZeroMQ benchmark failed: ") + e.what());
+    }
+
+    result.messages_lost = result.messages_sent - std::min(result.messages_sent, result.messages_received);
+    result.bytes_per_second = result.messages_per_second * static_cast<double>(config.message_size);
+
+    qDebug() << "ZeroMQ benchmark:" << result.messages_received << "of" << result.messages_sent
+             << "messages," << result.messages_per_second << "msg/s, p99 one-way"
+             << result.one_way.percentile(99).count() << "ns";
+    return result;
+}
+
+std::future<ZmqBenchmarkResult> ZmqBenchmark::runAsync(const ZmqBenchmarkConfig& config) {
+    return Executor::instance().submit([this, config]() {
+        return run(config);
+    });
+}
+
+void ZmqBenchmark::stop() {
+    is_running_ = false;
+}
+
+bool ZmqBenchmark::warmUp(Sockets& sockets) {
+    auto deadline = std::chrono::steady_clock::now() + kConnectTimeout;
+    bool probed = false;
+    while (std::chrono::steady_clock::now() < deadline && is_running_) {
+        // PUB drops messages until the subscription has arrived, so it keeps probing
+        if (!probed || sockets.config.pattern == ZeroMQHandler::Pattern::PUB_SUB) {
+            sockets.send(kProbe);
+            probed = true;
+        }
+
+        zmq::pollitem_t item{ sockets.receiver.handle(), 0, ZMQ_POLLIN, 0 };
+        if (zmq::poll(&item, 1, kProbeInterval) <= 0) {
+            continue;
+        }
+        zmq::message_t identity;
+        zmq::message_t message;
+        if (!sockets.receive(identity, message)) {
+            continue;
+        }
+        if (sockets.round_trip) {
+            zmq::message_t reply;
+            if (!sockets.echo(identity, message) || !sockets.sender.recv(reply)) {
+                break;
+            }
+        }
+        return true;
+    }
+    if (!is_running_) {
+        return false;
+    }
+    throw Error(ErrorCode::TIMEOUT, "Benchmark sockets did not connect on " + sockets.config.endpoint);
+}
+
+void ZmqBenchmark::runLatency(Sockets& sockets, ZmqBenchmarkResult& result) {
+    const auto& config = sockets.config;
+    auto started = std::chrono::steady_clock::now();
+
+    for (std::uint64_t sequence = 0; sequence < config.message_count && is_running_; ++sequence) {
+        if (!sockets.send(sequence)) {
+            break;
+        }
+        ++result.messages_sent;
+
+        // Late PUB probes may still be queued ahead of the message
+        zmq::message_t identity;
+        zmq::message_t message;
+        std::optional<Stamp> stamp;
+        do {
+            if (!sockets.receive(identity, message)) {
+                stamp.reset();
+                break;
+            }
+            stamp = readStamp(message);
+        } while (stamp && stamp->sequence == kProbe);
+        if (!stamp) {
+            break;  // Timed out, the message was lost
+        }
+        auto received_ns = nowNs();
+        ++result.messages_received;
+
+        if (!sockets.round_trip) {
+            result.one_way.record(std::chrono::nanoseconds(received_ns - stamp->sent_ns));
+            continue;
+        }
+
+        zmq::message_t reply;
+        if (!sockets.echo(identity, message) || !sockets.sender.recv(reply)) {
+            break;
+        }
+        if (auto echoed = readStamp(reply)) {
+            result.one_way.record(std::chrono::nanoseconds(echoed->echoed_ns - echoed->sent_ns));
+            result.round_trip.record(std::chrono::nanoseconds(nowNs() - echoed->sent_ns));
+        }
+    }
+
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    if (elapsed > 0) {
+        result.messages_per_second = static_cast<double>(result.messages_received) / elapsed;
+    }
+}
+
+void ZmqBenchmark::runThroughput(Sockets& sockets, ZmqBenchmarkResult& result) {
+    const auto& config = sockets.config;
+    std::atomic<bool> receiving{true};
+    std::atomic<std::size_t> sent{0};
+
+    // The sender socket is only used by this thread from here on
+    std::thread producer([&]() {
+        for (std::uint64_t sequence = 0; sequence < config.message_count && receiving && is_running_; ++sequence) {
+            if (!sockets.send(sequence)) {
+                break;
+            }
+            sent.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+
+    std::vector<bool> seen(config.message_count, false);
+    std::uint64_t highest = 0;
+    std::optional<std::chrono::steady_clock::time_point> first;
+    std::chrono::steady_clock::time_point last;
+
+    while (result.messages_received < config.message_count && is_running_) {
+        zmq::message_t identity;
+        zmq::message_t message;
+        if (!sockets.receive(identity, message)) {
+            break;  // Silent for receive_timeout, whatever is missing is lost
+        }
+        auto stamp = readStamp(message);
+        if (!stamp || stamp->sequence >= config.message_count || seen[stamp->sequence]) {
+            continue;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (!first) {
+            first = now;
+        }
+        last = now;
+
+        seen[stamp->sequence] = true;
+        if (stamp->sequence < highest) {
+            ++result.messages_reordered;
+        }
+        highest = std::max(highest, stamp->sequence);
+        ++result.messages_received;
+        result.one_way.record(std::chrono::nanoseconds(nowNs() - stamp->sent_ns));
+    }
+
+    receiving = false;
+    producer.join();
+    result.messages_sent = sent;
+
+    // Measured from the first receipt like local_thr, connection setup is not included
+    if (first && last > *first) {
+        auto elapsed = std::chrono::duration<double>(last - *first).count();
+        result.messages_per_second = static_cast<double>(result.messages_received - 1) / elapsed;
+    }
+}
+
+void ZmqBenchmark::validateConfig(const ZmqBenchmarkConfig& config) {
+    if (config.message_size < sizeof(Stamp)) {
+        throw Error(ErrorCode::INVALID_CONFIG,
+                    "Message size must be at least " + std::to_string(sizeof(Stamp)) + " bytes");
+    }
+
+    if (config.message_count == 0) {
+        throw Error(ErrorCode::INVALID_CONFIG, "Message count must be greater than 0");
+    }
+
+    if (!isLocalEndpoint(config.endpoint)) {
+        throw Error(ErrorCode::INVALID_CONFIG,
+                    "ZeroMQ benchmarks run over tcp://127.0.0.1, ipc:// or inproc:// only");
+    }
+}
+
+} // namespace flowdriver::testing